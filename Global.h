@@ -108,6 +108,9 @@ static inline int irand(double& seed, int size) {
 static inline double cpuTime(void) {
     return (double)clock() / CLOCKS_PER_SEC; }
 
+static inline double realTime(void) {
+    return (double)time(NULL); }
+
 static inline int64 memUsed() {
     return 0; }
 
@@ -123,6 +126,11 @@ static inline double cpuTime(void) {
     getrusage(RUSAGE_SELF, &ru);
     return (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1000000; }
 
+static inline double realTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1000000; }
+
 static inline int memReadStat(int field)
 {
     char    name[256];
@@ -70,6 +70,7 @@ class Heap {
     bool inHeap    (int n)    { assert(ok(n)); return indices[n] != 0; }
     void increase  (int n)    { assert(ok(n)); assert(inHeap(n)); percolateUp(indices[n]); }
     bool empty     ()         { return heap.size() == 1; }
+    void clear     ()         { for (int i = 1; i < heap.size(); i++) indices[heap[i]] = 0; heap.shrink(heap.size() - 1); }
 
     void insert(int n) {
         assert(ok(n));
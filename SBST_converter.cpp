@@ -5,6 +5,7 @@
 #include <utility>
 #include <regex>
 #include <map>
+#include <set>
 #include <stdlib.h>
 #include <time.h>
 #include "sat.h"
@@ -17,23 +18,23 @@ const int timeframe = 4;
 // Satsolver Basic CNF API
 Var addANDCNF(SatSolver& s, Var a, Var b, bool a_bool, bool b_bool) {
     Var out;
-    out = s.newVar();
+    out = s.newVar(false);
     s.addAigCNF(out, a, a_bool, b, b_bool);
     return out;
 }
 
 Var addXORCNF(SatSolver& s, Var a, Var b, bool a_bool, bool b_bool) {
     Var out;
-    out = s.newVar();
+    out = s.newVar(false);
     s.addXorCNF(out, a, a_bool, b, b_bool);
     return out;
 }
 
 Var addORCNF(SatSolver& s, Var a, Var b, bool a_bool, bool b_bool) {
     Var out1, out2;
-    out1 = s.newVar();
+    out1 = s.newVar(false);
     s.addAigCNF(out1, a, !a_bool, b, !b_bool);
-    out2 = s.newVar();
+    out2 = s.newVar(false);
     s.addAigCNF(out2, out1, true, out1, true);
     return out2;
 }
@@ -67,6 +68,275 @@ class Port {
         string port_name;
 };
 
+// Cache of SAT models projected onto the frame-0 scan cells
+// A pattern whose specified bits all agree with a stored witness is SAT without solving
+class WitnessCache {
+    public:
+        WitnessCache() {
+            witness_count = 0;
+            hit_count = 0;
+            hit_witness = -1;
+            pattern_conflict = false;
+        }
+        ~WitnessCache() {;}
+        // Start collecting the specified bits of a new pattern
+        void clearPattern() {
+            pattern_care.assign(pattern_care.size(), 0);
+            pattern_value.assign(pattern_value.size(), 0);
+            pattern_conflict = false;
+        }
+        // Record one scan cell of the current pattern, 'X' only registers the cell
+        void addPatternBit(Var v, char c) {
+            int k = scanIndex(v);
+            if (c != '0' && c != '1') {
+                return;
+            }
+            uint64 bit = (uint64)1 << (k & 63);
+            bool val = (c == '1');
+            if ((pattern_care[k >> 6] & bit) && ((pattern_value[k >> 6] & bit) != 0) != val) {
+                pattern_conflict = true;    // same cell assumed both ways, leave it to the solver
+            }
+            pattern_care[k >> 6] |= bit;
+            if (val) {
+                pattern_value[k >> 6] |= bit;
+            }
+        }
+        // Bit-sliced check of the current pattern against all stored witnesses,
+        // 64 witnesses are tested per word operation
+        bool findWitness() {
+            if (witness_count == 0 || pattern_conflict) {
+                return false;
+            }
+            int words = (witness_count + 63) >> 6;
+            alive.assign(words, ~(uint64)0);
+            if (witness_count & 63) {
+                alive[words - 1] = ((uint64)1 << (witness_count & 63)) - 1;
+            }
+            int checked = 0;
+            for (int w = 0; w < (int)pattern_care.size(); w++) {
+                for (uint64 care = pattern_care[w]; care != 0; care &= care - 1) {
+                    int k = (w << 6) + __builtin_ctzll(care);
+                    uint64 flip = (pattern_value[w] >> (k & 63) & 1) ? 0 : ~(uint64)0;
+                    const uint64* s = &slice[k][0];
+                    uint64* a = &alive[0];
+                    for (int i = 0; i < words; i++) {
+                        a[i] &= s[i] ^ flip;
+                    }
+                    if ((++checked & 7) == 0 && !anyAlive()) {
+                        return false;
+                    }
+                }
+            }
+            if (!anyAlive()) {
+                return false;
+            }
+            for (int i = 0; i < (int)alive.size(); i++) {
+                if (alive[i] != 0) {
+                    hit_witness = (i << 6) + __builtin_ctzll(alive[i]);
+                    break;
+                }
+            }
+            hit_count++;
+            return true;
+        }
+        // Frame-0 scan cell values of the solver's current model (the solver projects its models
+        // onto "getScanVars()"), false if there is no model
+        bool getModelBits(const SatSolver& s, vector<uint64>& bits) const {
+            s.getProjection(bits);
+            return bits.size() == pattern_care.size();
+        }
+        // Scan cell values of the witness found by the last successful "findWitness()"
+        void getHitWitness(vector<uint64>& bits) const {
+            bits.assign(pattern_care.size(), 0);
+            for (int k = 0; k < (int)scan_var.size(); k++) {
+                if (slice[k][hit_witness >> 6] >> (hit_witness & 63) & 1) {
+                    bits[k >> 6] |= (uint64)1 << (k & 63);
+                }
+            }
+        }
+        // Store the frame-0 scan cell values of the solver's current model
+        void addWitness(const SatSolver& s) {
+            vector<uint64> bits;
+            if (getModelBits(s, bits)) {
+                addWitness(bits);
+            }
+        }
+        void addWitness(const vector<uint64>& bits) {
+            if (bits.size() != pattern_care.size()) {
+                return;
+            }
+            int n = witness_count++;
+            for (int k = 0; k < (int)scan_var.size(); k++) {
+                if ((int)slice[k].size() <= (n >> 6)) {
+                    slice[k].push_back(0);
+                }
+                if (bits[k >> 6] >> (k & 63) & 1) {
+                    slice[k][n >> 6] |= (uint64)1 << (n & 63);
+                }
+            }
+        }
+        int getWitnessCount() const {return witness_count;}
+        int getHitCount() const {return hit_count;}
+        const vector<Var>& getScanVars() const {return scan_var;}
+        const vector<uint64>& getPatternCare() const {return pattern_care;}
+        const vector<uint64>& getPatternValue() const {return pattern_value;}
+        bool isPatternConflict() const {return pattern_conflict;}
+    private:
+        // Scan cell position of 'v' in the projection, new cells are appended
+        int scanIndex(Var v) {
+            map<Var, int>::iterator it = scan_index.find(v);
+            if (it != scan_index.end()) {
+                return it->second;
+            }
+            // Stored witnesses do not cover the new cell, drop them
+            int k = scan_var.size();
+            scan_index[v] = k;
+            scan_var.push_back(v);
+            slice.push_back(vector<uint64>());
+            for (int i = 0; i < k; i++) {
+                slice[i].clear();
+            }
+            witness_count = 0;
+            if ((k >> 6) >= (int)pattern_care.size()) {
+                pattern_care.push_back(0);
+                pattern_value.push_back(0);
+            }
+            return k;
+        }
+        bool anyAlive() const {
+            uint64 any = 0;
+            for (int i = 0; i < (int)alive.size(); i++) {
+                any |= alive[i];
+            }
+            return any != 0;
+        }
+        map<Var, int> scan_index;
+        vector<Var> scan_var;
+        // slice[k] bit n = value of scan cell k in witness n
+        vector<vector<uint64> > slice;
+        int witness_count;
+        int hit_count;
+        int hit_witness;
+        // Specified bits of the current pattern, packed by scan cell position
+        vector<uint64> pattern_care;
+        vector<uint64> pattern_value;
+        bool pattern_conflict;
+        vector<uint64> alive;
+};
+
+// Packed bits <-> hex string
+string PackBits(const vector<uint64>& bits) {
+    string str;
+    char buf[17];
+    for (int i=0; i<(int)bits.size(); i++) {
+        snprintf(buf, sizeof(buf), "%016llx", bits[i]);
+        str += buf;
+    }
+    return str.empty() ? "0" : str;
+}
+
+vector<uint64> UnpackBits(const string& str) {
+    vector<uint64> bits;
+    for (int i=0; i+16<=(int)str.size(); i+=16) {
+        bits.push_back(strtoull(str.substr(i, 16).c_str(), NULL, 16));
+    }
+    return bits;
+}
+
+uint64 HashMix(uint64 h, uint64 x) {
+    return (h ^ x) * 1099511628211ULL;
+}
+
+// One entry of the verdict database
+struct VerdictRecord {
+    char verdict;       // 'S' (SAT), 'U' (UNSAT) or '?' (UNKNOWN)
+    long long conflicts;
+    double seconds;
+    string payload;     // SAT: packed scan cell witness, UNSAT: conflict cube in DIMACS literals (empty: UNSAT under any pattern)
+};
+
+// Append-only on-disk store of pattern verdicts, keyed by
+// (hash of the compiled model, timeframe count, packed pattern bits).
+// One record per line, a line is only valid when it ends with the "." terminator,
+// so a record cut off by a crash is ignored on the next run.
+class VerdictDB {
+    public:
+        VerdictDB() {
+            lookup_count = 0;
+            hit_count = 0;
+        }
+        ~VerdictDB() {;}
+        // Load existing records and open the file for appending
+        bool open(string file_name) {
+            fstream fin;
+            fin.open(file_name, ios::in);
+            string line;
+            int load_count = 0;
+            while (fin && getline(fin, line)) {
+                stringstream ss(line);
+                string hash, frames, care, value, verdict, payload, end;
+                VerdictRecord rec;
+                if (!(ss >> hash >> frames >> care >> value >> verdict >> rec.conflicts >> rec.seconds >> payload >> end)
+                    || end != "." || verdict.size() != 1) {
+                    continue;
+                }
+                rec.verdict = verdict[0];
+                rec.payload = (payload == "-") ? "" : payload;
+                string key = hash + " " + frames + " " + care + " " + value;
+                // a definite verdict is never replaced by UNKNOWN
+                if (rec.verdict != '?' || record_map.find(key) == record_map.end()) {
+                    record_map[key] = rec;
+                }
+                load_count++;
+            }
+            fin.close();
+            fout.open(file_name, ios::out | ios::app);
+            if (!fout) {
+                cout << file_name << " can not be opened!" << endl;
+                return false;
+            }
+            cout << load_count << " verdict record loaded from " << file_name << endl;
+            return true;
+        }
+        bool isOpen() const {return fout.is_open();}
+        // Definite verdict of a pattern, false if not stored
+        bool lookup(uint64 model_hash, const vector<uint64>& care, const vector<uint64>& value, VerdictRecord& rec) {
+            if (!isOpen()) {
+                return false;
+            }
+            lookup_count++;
+            map<string, VerdictRecord>::iterator it = record_map.find(makeKey(model_hash, care, value));
+            if (it == record_map.end() || it->second.verdict == '?') {
+                return false;
+            }
+            hit_count++;
+            rec = it->second;
+            return true;
+        }
+        void append(uint64 model_hash, const vector<uint64>& care, const vector<uint64>& value, const VerdictRecord& rec) {
+            if (!isOpen()) {
+                return;
+            }
+            string key = makeKey(model_hash, care, value);
+            if (rec.verdict != '?' || record_map.find(key) == record_map.end()) {
+                record_map[key] = rec;
+            }
+            fout << key << " " << rec.verdict << " " << rec.conflicts << " " << rec.seconds << " "
+                 << (rec.payload.empty() ? "-" : rec.payload) << " ." << endl;
+        }
+        int getLookupCount() const {return lookup_count;}
+        int getHitCount() const {return hit_count;}
+    private:
+        string makeKey(uint64 model_hash, const vector<uint64>& care, const vector<uint64>& value) const {
+            vector<uint64> h(1, model_hash);
+            return PackBits(h) + " " + to_string(timeframe) + " " + PackBits(care) + " " + PackBits(value);
+        }
+        map<string, VerdictRecord> record_map;
+        fstream fout;
+        int lookup_count;
+        int hit_count;
+};
+
 // string manipulation
 void trim(string& s) {
     if (s.empty()) {
@@ -107,26 +377,27 @@ bool CheckSubString(string main_string, string subString) {
     }
 }
 
-// Create port
+// Create port (not a decision variable until BuildEquation() finds it free)
 Port CreatePort(SatSolver& s, string port_name) {
     Port p = Port();
     p.setName(port_name);
     for (int i=0; i<timeframe; i++) {
-        Var v = s.newVar();
+        Var v = s.newVar(false);
         p.timeFrameVarList[i] = v;
     }
     return p;
 }
 
-// Assume boolean value to specific port
-void AssumePort(SatSolver& s, Port& p, bool val) {
+// Assert boolean value to specific port in every timeframe
+void AssertPort(SatSolver& s, Port& p, bool val) {
     for (int i=0; i<timeframe; i++) {
-        s.assumeProperty(p.timeFrameVarList[i], val);
+        s.assertProperty(p.timeFrameVarList[i], val);
     }
 }
 
 // Assume port value in specific timeframe
-void AssumATPGport(SatSolver& solver, Var var_num, char c) {
+void AssumATPGport(SatSolver& solver, WitnessCache& witness_cache, Var var_num, char c) {
+    witness_cache.addPatternBit(var_num, c);
     if (c == '0') {
         solver.assumeProperty(var_num, 0);
     }
@@ -251,8 +522,11 @@ Var BuildEquation(SatSolver& solver, fstream& fin, vector<string>& input_list,
     cout << "Parse output port name successfully!!!" << endl;
 
     // Solver total variable
-    Var var_out = solver.newVar();
-    solver.assumeProperty(var_out, 1);
+    Var var_out = solver.newVar(false);
+
+    // Ports assigned by an equation
+    set<string> defined_ports;
+    solver.assertProperty(var_out, 1);
     base_assume_map[var_out] = 1;
 
     // Start parse combinational logic
@@ -272,6 +546,7 @@ Var BuildEquation(SatSolver& solver, fstream& fin, vector<string>& input_list,
             break;
         }
         trim(left_assignment);
+        defined_ports.insert(left_assignment);
         // Check if left assignment in port map
         // left assignment not in port map
         if (port_map.find(left_assignment) == port_map.end()) {
@@ -317,11 +592,11 @@ Var BuildEquation(SatSolver& solver, fstream& fin, vector<string>& input_list,
                     bool assume_logic = false;
                     if (stage_string.find("Logic0") != std::string::npos && stage_string.find("\'") != std::string::npos) {
                         assume_logic = true;
-                        AssumePort(solver, lhs_p, assume_logic);
+                        AssertPort(solver, lhs_p, assume_logic);
                     }
                     else {
                         assume_logic = false;
-                        AssumePort(solver, lhs_p, assume_logic);
+                        AssertPort(solver, lhs_p, assume_logic);
                     }
                     for (int i=0; i<timeframe; i++) {
                         base_assume_map[lhs_p.timeFrameVarList[i]] = assume_logic;
@@ -567,27 +842,61 @@ Var BuildEquation(SatSolver& solver, fstream& fin, vector<string>& input_list,
 
     cout << "Parse register DQ map successfully!!!" << endl;
 
+    // Mark decision variables: every timeframe of the free ports (primary inputs and undriven
+    // nets), and of register outputs only the last timeframe (the others equal the D port of the
+    // next timeframe). All other variables follow by propagation.
+    set<string> register_ports;
+    for (auto i = DQ_map.begin(); i != DQ_map.end(); i++) {
+        register_ports.insert(i->second);
+    }
+    for (auto i = DQN_map.begin(); i != DQN_map.end(); i++) {
+        register_ports.insert(i->second);
+    }
+    int decision_var_count = 0;
+    for (auto i = port_map.begin(); i != port_map.end(); i++) {
+        if (defined_ports.find(i->first) != defined_ports.end()) {
+            continue;
+        }
+        int first_free_time = (register_ports.find(i->first) != register_ports.end()) ? timeframe - 1 : 0;
+        for (int time=first_free_time; time<timeframe; time++) {
+            solver.setDecisionVar(i->second.timeFrameVarList[time], true);
+            decision_var_count++;
+        }
+    }
+    cout << "Decision variables: " << decision_var_count << "/" << solver.nVars() << endl;
+
     // Set rst_n = 1
     Port p = port_map["rst_n"];
     for (int i=0; i<timeframe; i++) {
-        solver.assumeProperty(p.timeFrameVarList[i], 1);
+        solver.assertProperty(p.timeFrameVarList[i], 1);
         base_assume_map[p.timeFrameVarList[i]] = 1;
     }
 
     return var_out;
 }
 
-// Make base assumption on boolean formula after assumption release
-void ReAssumeBaseAssumption(SatSolver& solver, map<Var, bool>& base_assume_map) {
+// Freeze the variables assumed later: base assumptions, the output, every timeframe of the
+// primary inputs and the frame-0 scan cells (pipeline registers)
+void FreezeInterface(SatSolver& solver, map<string, Port>& port_map, vector<string>& input_list,
+    map<string, string>& DFF_pipeline_map, map<Var, bool>& base_assume_map, Var var_out) {
     for (auto i = base_assume_map.begin(); i != base_assume_map.end(); i++) {
-        solver.assumeProperty(i->first, i->second);
+        solver.freeze(i->first);
+    }
+    solver.freeze(var_out);
+    for (int i=0; i<(int)input_list.size(); i++) {
+        for (int time=0; time<timeframe; time++) {
+            solver.freeze(port_map[input_list[i]].timeFrameVarList[time]);
+        }
+    }
+    for (auto i = DFF_pipeline_map.begin(); i != DFF_pipeline_map.end(); i++) {
+        solver.freeze(port_map[i->second].timeFrameVarList[0]);
     }
 
     return;
 }
 
 // Make ATPG assumption on the target scan registers
-void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, string>& DFF_pipeline_map,
+void AssumeATPG(SatSolver& solver, WitnessCache& witness_cache, map<string, Port>& port_map, map<string, string>& DFF_pipeline_map,
      map<string, string>& DFF_GPR_map, map<string, string>& ATPG_pattern_map, int pattern_idx)
 {
     // string of reg or input ATPG assignment
@@ -629,12 +938,12 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
     char IF_ID_compress_o_reg_str;
     string IF_ID_instr_o_reg_str = "";
     IF_ID_compress_o_reg_str = ATPG_pattern_map["IF_ID_compress_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["IF_ID_compress_o_reg"]].timeFrameVarList[0], IF_ID_compress_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["IF_ID_compress_o_reg"]].timeFrameVarList[0], IF_ID_compress_o_reg_str);
     for (int i=31; i>=0; i--) {
         string target_str = "IF_ID_instr_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         IF_ID_instr_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "IF_ID_compress_o_reg: " << IF_ID_compress_o_reg_str << endl;
     cout << "IF_ID_instr_o_reg: " << IF_ID_instr_o_reg_str << endl;
@@ -645,31 +954,31 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "ID_EX_EX_ALUOp_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_EX_ALUOp_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_EX_ALUOp_o_reg: " << ID_EX_EX_ALUOp_o_reg_str << endl;
     char ID_EX_EX_ALUSrc_o_reg_str;
     ID_EX_EX_ALUSrc_o_reg_str = ATPG_pattern_map["ID_EX_EX_ALUSrc_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["ID_EX_EX_ALUSrc_o_reg"]].timeFrameVarList[0], ID_EX_EX_ALUSrc_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["ID_EX_EX_ALUSrc_o_reg"]].timeFrameVarList[0], ID_EX_EX_ALUSrc_o_reg_str);
     cout << "ID_EX_EX_ALUSrc_o_reg: " << ID_EX_EX_ALUSrc_o_reg_str << endl;
     char ID_EX_EX_Jalr_o_reg_str;
     ID_EX_EX_Jalr_o_reg_str = ATPG_pattern_map["ID_EX_EX_Jalr_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["ID_EX_EX_Jalr_o_reg"]].timeFrameVarList[0], ID_EX_EX_Jalr_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["ID_EX_EX_Jalr_o_reg"]].timeFrameVarList[0], ID_EX_EX_Jalr_o_reg_str);
     cout << "ID_EX_EX_Jalr_o_reg: " << ID_EX_EX_Jalr_o_reg_str << endl;
     char ID_EX_M_MemRead_o_reg_str;
     ID_EX_M_MemRead_o_reg_str = ATPG_pattern_map["ID_EX_M_MemRead_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["ID_EX_M_MemRead_o_reg"]].timeFrameVarList[0], ID_EX_M_MemRead_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["ID_EX_M_MemRead_o_reg"]].timeFrameVarList[0], ID_EX_M_MemRead_o_reg_str);
     cout << "ID_EX_M_MemRead_o_reg: " << ID_EX_M_MemRead_o_reg_str << endl;
     char ID_EX_M_MemWrite_o_reg_str;
     ID_EX_M_MemWrite_o_reg_str = ATPG_pattern_map["ID_EX_M_MemWrite_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["ID_EX_M_MemWrite_o_reg"]].timeFrameVarList[0], ID_EX_M_MemWrite_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["ID_EX_M_MemWrite_o_reg"]].timeFrameVarList[0], ID_EX_M_MemWrite_o_reg_str);
     cout << "ID_EX_M_MemWrite_o_reg: " << ID_EX_M_MemWrite_o_reg_str << endl;
     string ID_EX_RDaddr_o_reg_str = "";
     for (int i=4; i>=0; i--) {
         string target_str = "ID_EX_RDaddr_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_RDaddr_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_RDaddr_o_reg: " << ID_EX_RDaddr_o_reg_str << endl;
     string ID_EX_RS1addr_o_reg_str = "";
@@ -677,7 +986,7 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "ID_EX_RS1addr_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_RS1addr_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_RS1addr_o_reg: " << ID_EX_RS1addr_o_reg_str << endl;
     string ID_EX_RS1data_o_reg_str = "";
@@ -685,7 +994,7 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "ID_EX_RS1data_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_RS1data_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_RS1data_o_reg: " << ID_EX_RS1data_o_reg_str << endl;
     string ID_EX_RS2addr_o_reg_str = "";
@@ -693,7 +1002,7 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "ID_EX_RS2addr_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_RS2addr_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_RS2addr_o_reg: " << ID_EX_RS2addr_o_reg_str << endl;
     string ID_EX_RS2data_o_reg_str = "";
@@ -701,7 +1010,7 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "ID_EX_RS2data_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_RS2data_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_RS2data_o_reg: " << ID_EX_RS2data_o_reg_str << endl;
     string ID_EX_WB_MemtoReg_o_reg_str = "";
@@ -709,28 +1018,28 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "ID_EX_WB_MemtoReg_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_WB_MemtoReg_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_WB_MemtoReg_o_reg: " << ID_EX_WB_MemtoReg_o_reg_str << endl;
     char ID_EX_WB_RegWrite_o_reg_str;
     ID_EX_WB_RegWrite_o_reg_str = ATPG_pattern_map["ID_EX_WB_RegWrite_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["ID_EX_WB_RegWrite_o_reg"]].timeFrameVarList[0], ID_EX_WB_RegWrite_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["ID_EX_WB_RegWrite_o_reg"]].timeFrameVarList[0], ID_EX_WB_RegWrite_o_reg_str);
     cout << "ID_EX_WB_RegWrite_o_reg: " << ID_EX_WB_RegWrite_o_reg_str << endl;
     char ID_EX_compress_o_reg_str;
     ID_EX_compress_o_reg_str = ATPG_pattern_map["ID_EX_compress_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["ID_EX_compress_o_reg"]].timeFrameVarList[0], ID_EX_compress_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["ID_EX_compress_o_reg"]].timeFrameVarList[0], ID_EX_compress_o_reg_str);
     cout << "ID_EX_compress_o_reg: " << ID_EX_compress_o_reg_str << endl;
     string ID_EX_funct3_o_reg_str = "";
     for (int i=2; i>=0; i--) {
         string target_str = "ID_EX_funct3_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_funct3_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_funct3_o_reg: " << ID_EX_funct3_o_reg_str << endl;
     char ID_EX_funct7_o_reg_str;
     ID_EX_funct7_o_reg_str = ATPG_pattern_map["ID_EX_funct7_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["ID_EX_funct7_o_reg"]].timeFrameVarList[0], ID_EX_funct7_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["ID_EX_funct7_o_reg"]].timeFrameVarList[0], ID_EX_funct7_o_reg_str);
     cout << "ID_EX_funct7_o_reg: " << ID_EX_funct7_o_reg_str << endl;
     string ID_EX_imm_o_reg_str = "";
     for (int i=21; i>=0; i--) {
@@ -743,7 +1052,7 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         }
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ID_EX_imm_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "ID_EX_imm_o_reg: " << ID_EX_imm_o_reg_str << endl;
 
@@ -753,27 +1062,27 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "EX_MEM_ALU_result_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         ALU_result_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "EX_MEM_ALU_result_o_reg: " << ALU_result_o_reg_str << endl;
     char EX_MEM_MEM_reg_hazard_o_reg_str;
     EX_MEM_MEM_reg_hazard_o_reg_str = ATPG_pattern_map["EX_MEM_MEM_reg_hazard_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["EX_MEM_MEM_reg_hazard_o_reg"]].timeFrameVarList[0], EX_MEM_MEM_reg_hazard_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["EX_MEM_MEM_reg_hazard_o_reg"]].timeFrameVarList[0], EX_MEM_MEM_reg_hazard_o_reg_str);
     cout << "EX_MEM_MEM_reg_hazard_o_reg: " << EX_MEM_MEM_reg_hazard_o_reg_str << endl;
     char EX_MEM_M_MemRead_o_reg_str;
     EX_MEM_M_MemRead_o_reg_str = ATPG_pattern_map["EX_MEM_M_MemRead_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["EX_MEM_M_MemRead_o_reg"]].timeFrameVarList[0], EX_MEM_M_MemRead_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["EX_MEM_M_MemRead_o_reg"]].timeFrameVarList[0], EX_MEM_M_MemRead_o_reg_str);
     cout << "EX_MEM_M_MemRead_o_reg: " << EX_MEM_M_MemRead_o_reg_str << endl;
     char EX_MEM_M_MemWrite_o_reg_str;
     EX_MEM_M_MemWrite_o_reg_str = ATPG_pattern_map["EX_MEM_M_MemWrite_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["EX_MEM_M_MemWrite_o_reg"]].timeFrameVarList[0], EX_MEM_M_MemWrite_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["EX_MEM_M_MemWrite_o_reg"]].timeFrameVarList[0], EX_MEM_M_MemWrite_o_reg_str);
     cout << "EX_MEM_M_MemWrite_o_reg: " << EX_MEM_M_MemWrite_o_reg_str << endl;
     string EX_MEM_RDaddr_o_reg_str = "";
     for (int i=4; i>=0; i--) {
         string target_str = "EX_MEM_RDaddr_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         EX_MEM_RDaddr_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "EX_MEM_RDaddr_o_reg: " << EX_MEM_RDaddr_o_reg_str << endl;
     string EX_MEM_RS2data_o_reg_str = "";
@@ -781,7 +1090,7 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "EX_MEM_RS2data_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         EX_MEM_RS2data_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str); 
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str); 
     }
     cout << "EX_MEM_RS2data_o_reg: " << EX_MEM_RS2data_o_reg_str << endl;
     string EX_MEM_WB_MemtoReg_o_reg_str = "";
@@ -789,12 +1098,12 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "EX_MEM_WB_MemtoReg_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         EX_MEM_WB_MemtoReg_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "EX_MEM_WB_MemtoReg_o_reg: " << EX_MEM_WB_MemtoReg_o_reg_str << endl;
     char EX_MEM_WB_RegWrite_o_reg_str;
     EX_MEM_WB_RegWrite_o_reg_str = ATPG_pattern_map["EX_MEM_WB_RegWrite_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["EX_MEM_WB_RegWrite_o_reg"]].timeFrameVarList[0], EX_MEM_WB_RegWrite_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["EX_MEM_WB_RegWrite_o_reg"]].timeFrameVarList[0], EX_MEM_WB_RegWrite_o_reg_str);
     cout << "EX_MEM_WB_RegWrite_o_reg: " << EX_MEM_WB_RegWrite_o_reg_str << endl;
 
     // Parse MEM_WB pipeline reg
@@ -803,7 +1112,7 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "MEM_WB_ALU_result_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         MEM_WB_ALU_result_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "MEM_WB_ALU_result_o_reg: " << MEM_WB_ALU_result_o_reg_str << endl;
     string MEM_WB_RDaddr_o_reg_str = "";
@@ -811,7 +1120,7 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "MEM_WB_RDaddr_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         MEM_WB_RDaddr_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "MEM_WB_RDaddr_o_reg: " << MEM_WB_RDaddr_o_reg_str << endl;
     string MEM_WB_WB_MemtoReg_o_reg_str = "";
@@ -819,19 +1128,19 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
         string target_str = "MEM_WB_WB_MemtoReg_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         MEM_WB_WB_MemtoReg_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "MEM_WB_WB_MemtoReg_o_reg: " << MEM_WB_WB_MemtoReg_o_reg_str << endl;
     char MEM_WB_WB_RegWrite_o_reg_str;
     MEM_WB_WB_RegWrite_o_reg_str = ATPG_pattern_map["MEM_WB_WB_RegWrite_o_reg"][pattern_idx];
-    AssumATPGport(solver, port_map[DFF_pipeline_map["MEM_WB_WB_RegWrite_o_reg"]].timeFrameVarList[0], MEM_WB_WB_RegWrite_o_reg_str);
+    AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map["MEM_WB_WB_RegWrite_o_reg"]].timeFrameVarList[0], MEM_WB_WB_RegWrite_o_reg_str);
     cout << "MEM_WB_WB_RegWrite_o_reg: " << MEM_WB_WB_RegWrite_o_reg_str << endl;
     string MEM_WB_data_o_reg_str = "";
     for (int i=31; i>=0; i--) {
         string target_str = "MEM_WB_data_o_reg_" + to_string(i) + "_";
         char cur_pattern_str = ATPG_pattern_map[target_str][pattern_idx];
         MEM_WB_data_o_reg_str += cur_pattern_str;
-        AssumATPGport(solver, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
+        AssumATPGport(solver, witness_cache, port_map[DFF_pipeline_map[target_str]].timeFrameVarList[0], cur_pattern_str);
     }
     cout << "MEM_WB_data_o_reg: " << MEM_WB_data_o_reg_str << endl;
     
@@ -839,7 +1148,224 @@ void AssumeATPG(SatSolver& solver, map<string, Port>& port_map, map<string, stri
     return;
 }
 
+// Hash identifying the compiled model together with its base assumptions and scan cells
+uint64 PatternModelHash(SatSolver& solver, map<Var, bool>& base_assume_map, WitnessCache& witness_cache) {
+    uint64 h = solver.getModelHash();
+    for (auto i = base_assume_map.begin(); i != base_assume_map.end(); i++) {
+        h = HashMix(h, (uint64)i->first * 2 + i->second);
+    }
+    const vector<Var>& scan_var = witness_cache.getScanVars();
+    for (int i=0; i<(int)scan_var.size(); i++) {
+        h = HashMix(h, scan_var[i]);
+    }
+    return h;
+}
+
+// Check one ATPG pattern, l_Undef if the budget runs out before an answer
+lbool CheckPattern(SatSolver& solver, WitnessCache& witness_cache, VerdictDB& verdict_db, map<string, Port>& port_map,
+    map<string, string>& DFF_pipeline_map, map<string, string>& DFF_GPR_map, map<string, string>& ATPG_pattern_map,
+    map<Var, bool>& base_assume_map, int pattern_idx, const SolveLimits& limits)
+{
+    witness_cache.clearPattern();
+    AssumeATPG(solver, witness_cache, port_map, DFF_pipeline_map, DFF_GPR_map, ATPG_pattern_map, pattern_idx);
+
+    // Patterns assuming a cell both ways have no packed key
+    bool use_db = verdict_db.isOpen() && !witness_cache.isPatternConflict();
+    uint64 model_hash = use_db ? PatternModelHash(solver, base_assume_map, witness_cache) : 0;
+    VerdictRecord rec;
+    lbool result;
+    if (use_db && verdict_db.lookup(model_hash, witness_cache.getPatternCare(), witness_cache.getPatternValue(), rec)) {
+        cout << "Reuse stored verdict" << endl;
+        result = (rec.verdict == 'S') ? l_True : l_False;
+        if (result == l_True) {
+            witness_cache.addWitness(UnpackBits(rec.payload));
+        }
+        use_db = false;     // already stored
+    }
+    // A stored model agreeing with every specified bit proves the pattern SAT
+    else if (witness_cache.findWitness()) {
+        cout << "Reuse stored witness" << endl;
+        result = l_True;
+        rec.conflicts = 0;
+        rec.seconds = 0;
+        vector<uint64> bits;
+        witness_cache.getHitWitness(bits);
+        rec.payload = PackBits(bits);
+    }
+    else {
+        // Solve the input variable ("var_out" is asserted already), keeping the scan cells of the model
+        solver.setProjection(witness_cache.getScanVars());
+        int64 start_conflicts = solver.getStats().conflicts;
+        double start_time = realTime();
+        result = solver.assumpSolve(limits);
+        rec.conflicts = solver.getStats().conflicts - start_conflicts;
+        rec.seconds = realTime() - start_time;
+        solver.printStats();
+        if (result == l_True) {
+            witness_cache.addWitness(solver);
+            vector<uint64> bits;
+            if (witness_cache.getModelBits(solver, bits)) {
+                rec.payload = PackBits(bits);
+            }
+        }
+        else if (result == l_False) {
+            const vec<Lit>& conflict = solver.getConflict();
+            for (int i=0; i<conflict.size(); i++) {
+                rec.payload += (i == 0 ? "" : ",") + to_string(toDimacs(conflict[i]));
+            }
+        }
+    }
+    if (use_db) {
+        rec.verdict = (result == l_True) ? 'S' : (result == l_False ? 'U' : '?');
+        verdict_db.append(model_hash, witness_cache.getPatternCare(), witness_cache.getPatternValue(), rec);
+    }
+
+    // clear the pattern assumptions (the base facts are level-0 units)
+    solver.assumeRelease();
+
+    return result;
+}
+
+string PrintResult(lbool result) {
+    if (result == l_True) {
+        return "SAT";
+    }
+    else if (result == l_False) {
+        return "UNSAT";
+    }
+    return "UNKNOWN";
+}
+
+// Parse "-key=value" argument, true -> matched
+bool ParseOption(string arg, string key, string& value) {
+    if (arg.compare(0, key.size() + 1, key + "=") != 0) {
+        return false;
+    }
+    value = arg.substr(key.size() + 1);
+    return true;
+}
+
+// Write the per-pattern verdicts of patterns [range_begin, range_end) out of pattern_count.
+// The "end" line marks a complete file.
+void WriteResult(fstream& fout, uint64 model_hash, int pattern_count, int range_begin, int range_end,
+    const vector<lbool>& result_list)
+{
+    vector<uint64> h(1, model_hash);
+    fout << "model " << PackBits(h) << endl;
+    fout << "range " << range_begin << " " << range_end << " " << pattern_count << endl;
+    for (int i=range_begin; i<range_end; i++) {
+        fout << "pattern " << i << " " << PrintResult(result_list[i - range_begin]) << endl;
+    }
+    fout << "end" << endl;
+}
+
+// Merge mode: Converter -merge <output file> <partial result file> ...
+// Combine the partial result files of all shards into one result file and the final report.
+int MergeResult(int argc, char* argv[]) {
+    string model_hash = "";
+    int pattern_count = -1;
+    map<int, string> verdict_map;
+    bool consistent = true;
+    for (int i=3; i<argc; i++) {
+        fstream fin;
+        fin.open(argv[i], ios::in);
+        if (!fin) {
+            cout << argv[i] << " can not be opened!" << endl;
+            consistent = false;
+            continue;
+        }
+        string line;
+        map<int, string> file_verdict_map;
+        bool complete = false;
+        while (getline(fin, line)) {
+            stringstream ss(line);
+            string tag;
+            ss >> tag;
+            if (tag == "model") {
+                string hash;
+                ss >> hash;
+                if (model_hash != "" && hash != model_hash) {
+                    cout << argv[i] << " is built from a different model!!!" << endl;
+                    consistent = false;
+                }
+                model_hash = hash;
+            }
+            else if (tag == "range") {
+                int range_begin, range_end, count;
+                ss >> range_begin >> range_end >> count;
+                if (pattern_count != -1 && count != pattern_count) {
+                    cout << argv[i] << " has a different pattern count!!!" << endl;
+                    consistent = false;
+                }
+                pattern_count = count;
+            }
+            else if (tag == "pattern") {
+                int idx;
+                string verdict;
+                ss >> idx >> verdict;
+                file_verdict_map[idx] = verdict;
+            }
+            else if (tag == "end") {
+                complete = true;
+            }
+        }
+        if (!complete) {
+            cout << argv[i] << " is incomplete and skipped!!!" << endl;
+            consistent = false;
+            continue;
+        }
+        for (auto j = file_verdict_map.begin(); j != file_verdict_map.end(); j++) {
+            // Overlapping shards must agree; a definite verdict wins over UNKNOWN
+            if (verdict_map.find(j->first) != verdict_map.end() && verdict_map[j->first] != j->second) {
+                if (verdict_map[j->first] != "UNKNOWN" && j->second != "UNKNOWN") {
+                    cout << "Pattern " << j->first << " has conflicting verdicts!!!" << endl;
+                    consistent = false;
+                }
+                if (j->second == "UNKNOWN") {
+                    continue;
+                }
+            }
+            verdict_map[j->first] = j->second;
+        }
+    }
+    if (pattern_count < 0) {
+        cout << "No partial result to merge!!!" << endl;
+        return 1;
+    }
+
+    fstream fout;
+    fout.open(argv[2], ios::out);
+    fout << "model " << model_hash << endl;
+    fout << "range 0 " << pattern_count << " " << pattern_count << endl;
+    int SAT_pattern_count = 0;
+    int unknown_count = 0;
+    int missing_count = 0;
+    for (int i=0; i<pattern_count; i++) {
+        if (verdict_map.find(i) == verdict_map.end()) {
+            missing_count++;
+            continue;
+        }
+        fout << "pattern " << i << " " << verdict_map[i] << endl;
+        SAT_pattern_count = (verdict_map[i] == "SAT") ? SAT_pattern_count + 1 : SAT_pattern_count;
+        unknown_count = (verdict_map[i] == "UNKNOWN") ? unknown_count + 1 : unknown_count;
+    }
+    if (missing_count == 0) {
+        fout << "end" << endl;
+    }
+
+    cout << "SATISFIABLE scan pattern / Total scan pattern: " << SAT_pattern_count << "/" << pattern_count << endl;
+    cout << "UNKNOWN scan pattern: " << unknown_count << endl;
+    if (missing_count > 0) {
+        cout << "Missing scan pattern: " << missing_count << endl;
+    }
+    return (consistent && missing_count == 0) ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "-merge") {
+        return MergeResult(argc, argv);
+    }
+
     fstream fin;
     fstream fout;
     // Input arguments
@@ -851,6 +1377,98 @@ int main(int argc, char* argv[]) {
     string DFF_pipeline_map_file_name = argv[5];
     string DFF_GPR_map_file_name = argv[6];
     string ATPG_pattern_name = argv[7];
+    // Optional arguments
+    // -conflicts=<n> -props=<n> -timeout=<sec> : budget of one pattern, UNKNOWN when exceeded
+    // -unknown=record|retry : keep UNKNOWN verdicts, or retry them at the end with -retry_scale=<k> times the budget
+    // -db=<file> : persistent verdict database, consulted before and appended after each pattern
+    // -shard=<i>/<n> or -range=<begin>:<end> : check only a slice of the patterns, merge with -merge
+    // -restart=geometric|luby|glucose -restart_block=0|1 : restart policy of the SAT solver
+    // -phase=false|saved|target -rephase=<n> : decision polarity, rephasing every <n>, 2<n>, ... conflicts (0 = never)
+    // -order=vsids|vmtf : decision variable order
+    // -justify=0|1 : branch on the inputs of unjustified gates first (ATPG-style)
+    // -chrono=<n> : backtrack a single level instead of more than <n> levels (0 = never)
+    // -elim=0|1 : bounded variable elimination of the internal signals before solving (default 0)
+    // -inprocess=0|1 : equivalent-signal substitution and failed-literal probing between patterns (default 0)
+    // -xor=0|1 : XOR gates as native XOR constraints (Gauss-Jordan elimination with -inprocess) or as clauses (default 0)
+    // -vivify=<seconds> : time for shortening learnt clauses between patterns (0 = never, the default: a time budget makes runs unreproducible)
+    SolveLimits pattern_limits;
+    SearchParams search_params = SearchParams(0.95, 0.999, 0.02);
+    int shard_idx = 0;
+    int shard_count = 0;
+    int range_begin = 0;
+    int range_end = -1;
+    string verdict_db_name = "";
+    string unknown_policy = "record";
+    int retry_scale = 10;
+    bool elim = false;
+    bool inprocess = false;
+    bool native_xor = false;
+    double vivify_time = 0;
+    for (int i=8; i<argc; i++) {
+        string value;
+        if (ParseOption(argv[i], "-conflicts", value)) {
+            pattern_limits.conflicts = atoll(value.c_str());
+        }
+        else if (ParseOption(argv[i], "-props", value)) {
+            pattern_limits.propagations = atoll(value.c_str());
+        }
+        else if (ParseOption(argv[i], "-timeout", value)) {
+            pattern_limits.seconds = atof(value.c_str());
+        }
+        else if (ParseOption(argv[i], "-unknown", value) && (value == "record" || value == "retry")) {
+            unknown_policy = value;
+        }
+        else if (ParseOption(argv[i], "-retry_scale", value) && atoi(value.c_str()) > 0) {
+            retry_scale = atoi(value.c_str());
+        }
+        else if (ParseOption(argv[i], "-db", value)) {
+            verdict_db_name = value;
+        }
+        else if (ParseOption(argv[i], "-shard", value) && value.find('/') != string::npos) {
+            shard_idx = atoi(value.substr(0, value.find('/')).c_str());
+            shard_count = atoi(value.substr(value.find('/') + 1).c_str());
+        }
+        else if (ParseOption(argv[i], "-range", value) && value.find(':') != string::npos) {
+            range_begin = atoi(value.substr(0, value.find(':')).c_str());
+            range_end = atoi(value.substr(value.find(':') + 1).c_str());
+        }
+        else if (ParseOption(argv[i], "-restart", value) && (value == "geometric" || value == "luby" || value == "glucose")) {
+            search_params.restart = (value == "luby") ? restart_Luby : (value == "glucose") ? restart_Glucose : restart_Geometric;
+        }
+        else if (ParseOption(argv[i], "-restart_block", value)) {
+            search_params.restart_blocking = (atoi(value.c_str()) != 0);
+        }
+        else if (ParseOption(argv[i], "-phase", value) && (value == "false" || value == "saved" || value == "target")) {
+            search_params.phase = (value == "false") ? phase_False : (value == "target") ? phase_Target : phase_Saved;
+        }
+        else if (ParseOption(argv[i], "-rephase", value) && atoi(value.c_str()) >= 0) {
+            search_params.rephase_first = atoi(value.c_str());
+        }
+        else if (ParseOption(argv[i], "-order", value) && (value == "vsids" || value == "vmtf")) {
+            search_params.var_order = (value == "vmtf") ? order_VMTF : order_VSIDS;
+        }
+        else if (ParseOption(argv[i], "-justify", value)) {
+            search_params.justify = (atoi(value.c_str()) != 0);
+        }
+        else if (ParseOption(argv[i], "-chrono", value) && atoi(value.c_str()) >= 0) {
+            search_params.chrono = atoi(value.c_str());
+        }
+        else if (ParseOption(argv[i], "-elim", value)) {
+            elim = (atoi(value.c_str()) != 0);
+        }
+        else if (ParseOption(argv[i], "-inprocess", value)) {
+            inprocess = (atoi(value.c_str()) != 0);
+        }
+        else if (ParseOption(argv[i], "-xor", value)) {
+            native_xor = (atoi(value.c_str()) != 0);
+        }
+        else if (ParseOption(argv[i], "-vivify", value) && atof(value.c_str()) >= 0) {
+            vivify_time = atof(value.c_str());
+        }
+        else {
+            cout << "Unknown option " << argv[i] << " is ignored!!!" << endl;
+        }
+    }
     // Open input/output files
     fin.open(equation_file_name, ios::in);
     if (!fin) {
@@ -866,6 +1484,10 @@ int main(int argc, char* argv[]) {
     // Initialize SAT solver
     SatSolver solver;
     solver.initialize();
+    solver.setSearchParams(search_params);
+    solver.setNativeXor(native_xor);
+    // Only the scan cells of a model are read
+    solver.setFullModel(false);
 
     // input port name list
     vector<string> input_list;
@@ -886,35 +1508,112 @@ int main(int argc, char* argv[]) {
     // Read ATPG pattern
     map<string, string> ATPG_pattern_map = ReadDictionary(ATPG_pattern_name);
 
-    // Record Base assumption var list
+    // Record Base assumption var list (asserted as level-0 units while building)
     map<Var, bool> base_assume_map;
 
     // Build SAT equation
     Var var_out = BuildEquation(solver, fin, input_list, port_map, output_list, DQ_map, DQN_map, base_assume_map);
 
     cout << "Building circuit equation successfully!!!" << endl;
+    // Every pattern asks for the property: assert it once instead of assuming it each time
+    solver.assertProperty(var_out, true);
+    cout << "XOR constraints: " << solver.nXors() << endl;
+
+    // Simplify the CNF, keeping every variable the patterns assume or read
+    if (elim || inprocess) {
+        FreezeInterface(solver, port_map, input_list, DFF_pipeline_map, base_assume_map, var_out);
+    }
+    if (elim) {
+        int clause_count = solver.nClauses();
+        solver.eliminate();
+        cout << "Eliminated variables: " << solver.nEliminated() << "/" << solver.nVars() << endl;
+        cout << "Clauses before / after elimination: " << clause_count << "/" << solver.nClauses() << endl;
+    }
 
     int ATPG_pattern_count = ATPG_pattern_map["register_reg_25__28_"].size();
     int SAT_pattern_count = 0;
     // int ATPG_pattern_count = 5;
     cout << ATPG_pattern_count << " of ATPG pattern to be converted!!!" << endl;
 
-    for (int i=0; i<ATPG_pattern_count; i++) {
-        AssumeATPG(solver, port_map, DFF_pipeline_map, DFF_GPR_map, ATPG_pattern_map, i);
+    // Pattern slice of this process
+    if (shard_count > 0 && shard_idx >= 0 && shard_idx < shard_count) {
+        range_begin = (long long)ATPG_pattern_count * shard_idx / shard_count;
+        range_end = (long long)ATPG_pattern_count * (shard_idx + 1) / shard_count;
+    }
+    range_end = (range_end < 0 || range_end > ATPG_pattern_count) ? ATPG_pattern_count : range_end;
+    range_begin = (range_begin < 0) ? 0 : (range_begin > range_end ? range_end : range_begin);
+    if (range_begin != 0 || range_end != ATPG_pattern_count) {
+        cout << "Check scan pattern " << range_begin << " to " << range_end - 1 << endl;
+    }
 
-        // Set Satisfiable & solve the input variable
-        solver.assumeProperty(var_out, true);
-        bool result = solver.assumpSolve();
-        solver.printStats();
-        cout << (result ? "SAT" : "UNSAT") << endl;
-        SAT_pattern_count = (result) ? SAT_pattern_count + 1 : SAT_pattern_count;
+    // Frame-0 scan cell values of SAT models found so far
+    WitnessCache witness_cache;
+    // Verdicts of earlier runs
+    VerdictDB verdict_db;
+    if (verdict_db_name != "") {
+        verdict_db.open(verdict_db_name);
+    }
 
-        // clear all the assumption & reassume base assumption
-        solver.assumeRelease();
-        ReAssumeBaseAssumption(solver, base_assume_map);
+    vector<lbool> result_list(range_end - range_begin, l_Undef);
+    vector<int> unknown_list;
+    for (int i=range_begin; i<range_end; i++) {
+        if (inprocess) {
+            solver.inprocess();
+        }
+        if (vivify_time > 0) {
+            solver.vivify(vivify_time);
+        }
+        lbool result = CheckPattern(solver, witness_cache, verdict_db, port_map, DFF_pipeline_map, DFF_GPR_map,
+            ATPG_pattern_map, base_assume_map, i, pattern_limits);
+        cout << PrintResult(result) << endl;
+        result_list[i - range_begin] = result;
+        SAT_pattern_count = (result == l_True) ? SAT_pattern_count + 1 : SAT_pattern_count;
+        if (result == l_Undef) {
+            unknown_list.push_back(i);
+        }
     }
 
-    cout << "SATISFIABLE scan pattern / Total scan pattern: " << SAT_pattern_count << "/" << ATPG_pattern_count << endl;
+    // Retry UNKNOWN patterns once with a larger budget
+    if (unknown_policy == "retry" && !unknown_list.empty()) {
+        SolveLimits retry_limits = pattern_limits;
+        retry_limits.conflicts = (retry_limits.conflicts < 0) ? -1 : retry_limits.conflicts * retry_scale;
+        retry_limits.propagations = (retry_limits.propagations < 0) ? -1 : retry_limits.propagations * retry_scale;
+        retry_limits.seconds = (retry_limits.seconds < 0) ? -1 : retry_limits.seconds * retry_scale;
+        cout << "Retry " << unknown_list.size() << " UNKNOWN pattern with " << retry_scale << "x budget" << endl;
+        vector<int> still_unknown;
+        for (int j=0; j<(int)unknown_list.size(); j++) {
+            if (inprocess) {
+                solver.inprocess();
+            }
+            if (vivify_time > 0) {
+                solver.vivify(vivify_time);
+            }
+            lbool result = CheckPattern(solver, witness_cache, verdict_db, port_map, DFF_pipeline_map, DFF_GPR_map,
+                ATPG_pattern_map, base_assume_map, unknown_list[j], retry_limits);
+            cout << "Retry " << unknown_list[j] << ": " << PrintResult(result) << endl;
+            result_list[unknown_list[j] - range_begin] = result;
+            SAT_pattern_count = (result == l_True) ? SAT_pattern_count + 1 : SAT_pattern_count;
+            if (result == l_Undef) {
+                still_unknown.push_back(unknown_list[j]);
+            }
+        }
+        unknown_list = still_unknown;
+    }
+
+    cout << "SATISFIABLE scan pattern / Total scan pattern: " << SAT_pattern_count << "/" << range_end - range_begin << endl;
+    cout << "UNKNOWN scan pattern: " << unknown_list.size() << endl;
+    WriteResult(fout, solver.getModelHash(), ATPG_pattern_count, range_begin, range_end, result_list);
+    cout << "Witness reuse / Stored witness: " << witness_cache.getHitCount() << "/" << witness_cache.getWitnessCount() << endl;
+    if (verdict_db.isOpen()) {
+        cout << "Stored verdict reuse / Lookup: " << verdict_db.getHitCount() << "/" << verdict_db.getLookupCount() << endl;
+    }
+    const SolverStats& stats = solver.getStats();
+    cout << "Conflicts / Restarts / Blocked restarts: " << stats.conflicts << "/" << stats.starts << "/" << stats.blocked_restarts << endl;
+    cout << "Decisions / Fallback decisions / Rephases: " << stats.decisions << "/" << stats.fallback_decisions << "/" << stats.rephases << endl;
+    cout << "Propagations / Chronological backtracks: " << stats.propagations << "/" << stats.chrono_backtracks << endl;
+    cout << "Substituted variables / Failed literals: " << stats.substituted << "/" << stats.failed_literals << endl;
+    cout << "XOR constraints / Gauss facts: " << solver.nXors() << "/" << stats.gauss_facts << endl;
+    cout << "Vivified learnt clauses / Literals removed: " << stats.vivified << "/" << stats.vivified_literals << endl;
 
     // Set IF-ID reg 11100101000000010000000100010011
     // cout << port_map[DFF_pipeline_map["IF_ID_instr_o_reg_0_"]].timeFrameVarList[0] << endl;
@@ -27,23 +27,32 @@ int effLimit = INT_MAX;
 // Helper functions:
 
 
-void removeWatch(vec<Clause*>& ws, Clause* elem)
+void removeWatch(vec<Watcher>& ws, CRef elem)
 {
     if (ws.size() == 0) return;     // (skip lists that are already cleared)
     int j = 0;
-    for (; ws[j] != elem  ; j++) assert(j < ws.size());
+    for (; ws[j].cref != elem; j++) assert(j < ws.size());
     for (; j < ws.size()-1; j++) ws[j] = ws[j+1];
     ws.pop();
 }
 
 
+void removeOcc(vec<CRef>& cs, CRef elem)
+{
+    int j = 0;
+    for (; cs[j] != elem; j++) assert(j < cs.size());
+    for (; j < cs.size()-1; j++) cs[j] = cs[j+1];
+    cs.pop();
+}
+
+
 //=================================================================================================
 // Operations on clauses:
 
 
 /*_________________________________________________________________________________________________
 |
-|  newClause : (ps : const vec<Lit>&) (learnt : bool) (id : ClauseId)  ->  [void]
+|  newClause : (ps : const vec<Lit>&) (learnt : bool) (id : ClauseId) (A : bool) (lbd : int)  ->  [void]
 |  
 |  Description:
 |    Allocate and add a new clause to the SAT solvers clause database. If a conflict is detected,
@@ -56,11 +65,13 @@ void removeWatch(vec<Clause*>& ws, Clause* elem)
 |             literal. One of the watches will always be on this literal, the other will be set to
 |             the literal with the highest decision level.
 |    id     - If logging proof, learnt clauses should be given an ID by caller.
+|    A      - (Proof logging) Which side of an interpolation split the problem clause belongs to.
+|    lbd    - Learnt clauses only: literal block distance, decides the initial tier.
 |  
 |  Effect:
 |    Activity heuristics are updated.
 |________________________________________________________________________________________________@*/
-void Solver::newClause(const vec<Lit>& ps_, bool learnt, ClauseId id , bool A)
+void Solver::newClause(const vec<Lit>& ps_, bool learnt, ClauseId id , bool A, int lbd)
 {
     assert(learnt || id == ClauseId_NULL);
     if (!ok) return;
@@ -98,65 +109,165 @@ void Solver::newClause(const vec<Lit>& ps_, bool learnt, ClauseId id , bool A)
         ok = false;
 
     }else if (ps.size() == 1){
-        // NOTE: If enqueue takes place at root level, the assignment will be lost in incremental use (it doesn't seem to hurt much though).
+        // A unit is a top-level fact at any decision level ('cancelUntil()' keeps it when the assumptions are undone):
         if (id != ClauseId_NULL)
             unit_id[var(ps[0])] = id;
-        if (!enqueue(ps[0]))
+        if (!enqueue(ps[0], GClause_NULL, 0))
             ok = false;
 
+    }else if (ps.size() == 2){
+        // Binary clauses are not allocated, only stored in the implication lists:
+        bin_watches[index(~ps[0])].push(ps[1]);
+        bin_watches[index(~ps[1])].push(ps[0]);
+        if (proof != NULL){
+            bin_ids[index(~ps[0])].push(id);
+            bin_ids[index(~ps[1])].push(id); }
+        n_bin_clauses++;
+        stats.clauses_literals += 2;
+
+        if (learnt)
+            // Enqueue asserting literal (the reason is the other, false literal):
+            check(enqueue(ps[0], GClause_new(ps[1]), chrono_lim > 0 ? vardata[var(ps[1])].level : -1));
+
     }else{
         // Allocate clause:
-        Clause* c   = Clause_new(learnt, ps, id);
+        CRef    cr = ca.alloc(learnt, ps, id);
+        Clause& c  = ca[cr];
 
         if (learnt){
             // Put the second watch on the literal with highest decision level:
             int     max_i = 1;
-            int     max   = level[var(ps[1])];
+            int     max   = vardata[var(ps[1])].level;
             for (int i = 2; i < ps.size(); i++)
-                if (level[var(ps[i])] > max)
-                    max   = level[var(ps[i])],
+                if (vardata[var(ps[i])].level > max)
+                    max   = vardata[var(ps[i])].level,
                     max_i = i;
-            (*c)[1]     = ps[max_i];
-            (*c)[max_i] = ps[1];
+            c[1]     = ps[max_i];
+            c[max_i] = ps[1];
 
             // Bumping:
             claBumpActivity(c); // (newly learnt clauses should be considered active)
+            c.setLbd(lbd);
+            c.setTier(lbdTier(lbd));
+            c.setUsed(c.tier() == tier_Core ? 2 : 1);
+            learnts_tier[c.tier()]++;
 
-            // Enqueue asserting literal:
-            check(enqueue((*c)[0], c));
+            // Enqueue asserting literal (at the level of 'c[1]' if backtracking was chronological):
+            check(enqueue(c[0], GClause_new(cr), chrono_lim > 0 ? max : -1));
 
             // Store clause:
-            watches[index(~(*c)[0])].push(c);
-            watches[index(~(*c)[1])].push(c);
-            learnts.push(c);
-            stats.learnts_literals += c->size();
+            watches[index(~c[0])].push(Watcher(cr, c[1]));
+            watches[index(~c[1])].push(Watcher(cr, c[0]));
+            learnts.push(cr);
+            stats.learnts_literals += c.size();
 
         }else{
             // Store clause:
-            watches[index(~(*c)[0])].push(c);
-            watches[index(~(*c)[1])].push(c);
-            clauses.push(c);
-            stats.clauses_literals += c->size();
+            watches[index(~c[0])].push(Watcher(cr, c[1]));
+            watches[index(~c[1])].push(Watcher(cr, c[0]));
+            clauses.push(cr);
+            stats.clauses_literals += c.size();
         }
     }
 }
 
 
 // Disposes a clauses and removes it from watcher lists. NOTE! Low-level; does NOT change the 'clauses' and 'learnts' vector.
+// The memory is only reclaimed by the next 'garbageCollect()'.
 //
-void Solver::remove(Clause* c, bool just_dealloc)
+void Solver::remove(CRef cr, bool just_dealloc)
 {
+    Clause& c = ca[cr];
     if (!just_dealloc){
-        removeWatch(watches[index(~(*c)[0])], c),
-        removeWatch(watches[index(~(*c)[1])], c);
+        removeWatch(watches[index(~c[0])], cr),
+        removeWatch(watches[index(~c[1])], cr);
+
+        if (c.learnt()) stats.learnts_literals -= c.size(), learnts_tier[c.tier()]--;
+        else            stats.clauses_literals -= c.size();
 
-        if (c->learnt()) stats.learnts_literals -= c->size();
-        else             stats.clauses_literals -= c->size();
+        if (proof != NULL) proof->deleted(c.id());
+    }
+
+    ca.free(cr);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  newXor : (ps : const vec<Lit>&)  ->  [void]
+|  
+|  Description:
+|    Add the constraint that the XOR of the literals 'ps' is true (at the top level). Repeated
+|    variables cancel out and assigned ones are removed. With one or two literals left, it is
+|    added as a unit or as two binary clauses. Longer constraints are stored in 'ca' and watched
+|    on the variables of their first two literals (see 'propagate()'), unless 'native_xor' is
+|    off or proofs are logged: then all its clauses are added instead.
+|________________________________________________________________________________________________@*/
+void Solver::newXor(const vec<Lit>& ps)
+{
+    if (!ok) return;
+    assert(decisionLevel() == 0);
 
-        if (proof != NULL) proof->deleted(c->id());
+    // Positive literals and the parity they must have:
+    vec<Lit>    qs;
+    bool        parity = true;
+    for (int i = 0; i < ps.size(); i++){
+        parity ^= sign(ps[i]);
+        if (value(ps[i]) == l_Undef)
+            qs.push(Lit(var(ps[i])));
+        else
+            parity ^= (value(var(ps[i])) == l_True);
+    }
+    sort(qs);
+    int     i, j;
+    for (i = j = 0; i < qs.size(); i++){
+        if (i+1 < qs.size() && qs[i] == qs[i+1])
+            i++;
+        else
+            qs[j++] = qs[i];
     }
+    qs.shrink(i - j);
+
+    if (qs.size() == 0){
+        if (parity) ok = false;
+        return; }
+    if (!parity)
+        qs[0] = ~qs[0];     // (now the XOR of 'qs' is true)
+
+    vec<Lit>    lits;
+    if (qs.size() <= 2 || !native_xor || proof != NULL){
+        // All clauses of the constraint (one per assignment with the wrong parity, which it excludes):
+        for (int mask = 0; mask < (1 << qs.size()); mask++){
+            bool odd = false;
+            for (int k = 0; k < qs.size(); k++)
+                odd ^= (mask >> k) & 1;
+            if (odd) continue;
+            lits.clear();
+            for (int k = 0; k < qs.size(); k++)
+                lits.push(((mask >> k) & 1) ? ~qs[k] : qs[k]);
+            newClause(lits);
+        }
+        return; }
+
+    CRef    cr = ca.alloc(false, qs);
+    Clause& c  = ca[cr];
+    c.setXor();
+    xor_watches[var(c[0])].push(cr);
+    xor_watches[var(c[1])].push(cr);
+    xors.push(cr);
+    gauss_dirty = true;
+}
 
-    xfree(c);
+
+// Disposes an XOR constraint and removes it from the XOR watcher lists (not from 'xors').
+//
+void Solver::removeXor(CRef cr)
+{
+    Clause& c = ca[cr];
+    removeOcc(xor_watches[var(c[0])], cr);
+    removeOcc(xor_watches[var(c[1])], cr);
+    ca.free(cr);
+    gauss_dirty = true;
 }
 
 
@@ -164,11 +275,12 @@ void Solver::remove(Clause* c, bool just_dealloc)
 // the clause is binary and satisfied, in which case the first literal is true)
 // Returns True if clause is satisfied (will be removed), False otherwise.
 //
-bool Solver::simplify(Clause* c) const
+bool Solver::simplify(CRef cr) const
 {
     assert(decisionLevel() == 0);
-    for (int i = 0; i < c->size(); i++){
-        if (value((*c)[i]) == l_True)
+    const Clause& c = ca[cr];
+    for (int i = 0; i < c.size(); i++){
+        if (value(c[i]) == l_True)
             return true;
     }
     return false;
@@ -179,42 +291,69 @@ bool Solver::simplify(Clause* c) const
 // Minor methods:
 
 
-// Creates a new SAT variable in the solver. If 'decision_var' is cleared, variable will not be
-// used as a decision variable (NOTE! This has effects on the meaning of a SATISFIABLE result).
+// Creates a new SAT variable in the solver. If 'dvar' is cleared, variable will not be used as a
+// decision variable as long as there are unassigned decision variables left (see 'pickBranchLit()').
 //
-Var Solver::newVar() {
+Var Solver::newVar(bool dvar) {
     int     index;
     index = nVars();
     watches     .push();          // (list for positive literal)
     watches     .push();          // (list for negative literal)
-    reason      .push(NULL);
+    bin_watches .push();
+    bin_watches .push();
+    if (proof != NULL) bin_ids.push(), bin_ids.push();
+    xor_watches .push();
+    vardata     .push();
     assigns     .push(toInt(l_Undef));
-    level       .push(-1);
-    trail_pos   .push(-1);
+    decision    .push(dvar);
+    gates       .push();
+    frozen      .push(0);
+    eliminated  .push(0);
+    polarity    .push(1);
+    target_polarity.push(1);
+    seed_polarity.push(1);
     activity    .push(0);
     order       .newVar();
     analyze_seen.push(0);
+    computeLbd_seen.push(0);
     if (proof != NULL) unit_id.push(ClauseId_NULL);
     return index; }
 
 
+void Solver::setDecisionVar(Var x, bool b) {
+    if (decision[x] == (char)b) return;
+    decision[x] = b;
+    order.setDecision(x); }
+
+
 // Returns FALSE if immediate conflict.
 bool Solver::assume(Lit p) {
     trail_lim.push(trail.size());
     return enqueue(p); }
 
 
-// Revert to the state at given level.
+// Revert to the state at given level. Literals above 'trail_lim[level]' that are of 'level' or lower
+// (units, and implications after chronological backtracking) are kept, and propagated again.
 void Solver::cancelUntil(int level) {
     if (decisionLevel() > level){
+        vec<Lit>& kept = cancelUntil_kept;
+        kept.clear();
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var     x  = var(trail[c]);
+            if (vardata[x].level <= level){
+                kept.push(trail[c]); continue; }
+            polarity[x] = sign(trail[c]);
             assigns[x] = toInt(l_Undef);
-            reason [x] = NULL;
+            vardata[x].reason = GClause_NULL;
             order.undo(x); }
         trail.shrink(trail.size() - trail_lim[level]);
+        if (target_saved > trail.size()) target_saved = trail.size();
+        if (justify_head > trail.size()) justify_head = trail.size();
+        fallback_next = 0;
         trail_lim.shrink(trail_lim.size() - level);
-        qhead = trail.size(); } }
+        qhead = trail.size();
+        for (int i = kept.size()-1; i >= 0; i--)
+            trail.push(kept[i]); } }
 
 
 //=================================================================================================
@@ -223,11 +362,11 @@ void Solver::cancelUntil(int level) {
 
 /*_________________________________________________________________________________________________
 |
-|  analyze : (confl : Clause*) (out_learnt : vec<Lit>&) (out_btlevel : int&)  ->  [void]
+|  analyze : (confl : CRef) (out_learnt : vec<Lit>&) (out_btlevel : int&) (out_lbd : int&)  ->  [void]
 |  
 |  Description:
-|    Analyze conflict and produce a reason clause ('out_learnt') and a backtracking level
-|    ('out_btlevel').
+|    Analyze conflict and produce a reason clause ('out_learnt'), a backtracking level
+|    ('out_btlevel') and the literal block distance of the reason clause ('out_lbd').
 |  
 |    Pre-conditions:
 |      * 'out_learnt' is assumed to be cleared.
@@ -238,13 +377,7 @@ void Solver::cancelUntil(int level) {
 |      * If performing proof-logging, the last derived clause in the proof is the reason clause.
 |________________________________________________________________________________________________@*/
 
-class lastToFirst_lt {  // Helper class to 'analyze' -- order literals from last to first occurance in 'trail[]'.
-    const vec<int>& trail_pos;
-public:
-    lastToFirst_lt(const vec<int>& t) : trail_pos(t) {}
-    bool operator () (Lit p, Lit q) { return trail_pos[var(p)] > trail_pos[var(q)]; }
-};
-void Solver::analyze(Clause* confl, vec<Lit>& out_learnt, int& out_btlevel)
+void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& out_lbd)
 {
     vec<char>&     seen  = analyze_seen;
     int            pathC = 0;
@@ -252,43 +385,50 @@ void Solver::analyze(Clause* confl, vec<Lit>& out_learnt, int& out_btlevel)
 
     // Generate conflict clause:
     //
-    if (proof != NULL) proof->beginChain(confl->id());
+    if (proof != NULL) proof->beginChain(ca[confl].id());
     out_learnt.push();          // (leave room for the asserting literal)
-    out_btlevel = 0;
     int index = trail.size()-1;
     for(;;){
-        assert(confl != NULL);  // (otherwise should be UIP)
+        assert(confl != CRef_Undef);    // (otherwise should be UIP)
 
-        Clause& c = *confl;
+        Clause& c = ca[confl];
         if (c.learnt())
-            claBumpActivity(&c);
+            claBumpActivity(c),
+            claUpdateLbd(c);
 
+        int n_root = 0;
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
             if (!seen[var(q)]){
-                if (level[var(q)] > 0){
+                if (vardata[var(q)].level > 0){
                     varBumpActivity(q);
                     seen[var(q)] = 1;
-                    if (level[var(q)] == decisionLevel())
+                    if (vardata[var(q)].level == decisionLevel())
                         pathC++;
                     else{
                         out_learnt.push(q);
-                        out_btlevel = max(out_btlevel, level[var(q)]);
                     }
-                }else
+                }else{
+                    n_root++;
                     if (proof != NULL) proof->resolve(unit_id[var(q)], q);
+                }
             }
         }
 
-        // Select next clause to look at:
-        while (!seen[var(trail[index--])]);
-        p     = trail[index+1];
-        confl = reason[var(p)];
+        // On-the-fly subsumption: the resolvent is the reason clause without 'p', which can be
+        // removed from it (there are still 'pathC >= 2' literals of this level to watch). Not for
+        // XOR constraints, which only read as this clause for the moment:
+        if (p != lit_Undef && n_root == 0 && pathC >= 2 && c.size() > 3 && pathC + out_learnt.size() == c.size() && !c.isXor())
+            strengthenReason(confl);
+
+        // Select next clause to look at (lower levels may be interleaved after chronological backtracking):
+        do p = trail[index--]; while (!seen[var(p)] || vardata[var(p)].level < decisionLevel());
+        confl = reasonClause(var(p));
         seen[var(p)] = 0;
         pathC--;
         if (pathC == 0) break;
 
-        if (proof != NULL) proof->resolve(confl->id(), ~p);
+        if (proof != NULL) proof->resolve(ca[confl].id(), ~p);
     }
     out_learnt[0] = ~p;
 
@@ -300,24 +440,23 @@ void Solver::analyze(Clause* confl, vec<Lit>& out_learnt, int& out_btlevel)
         //
         uint    min_level = 0;
         for (i = 1; i < out_learnt.size(); i++)
-            min_level |= 1 << (level[var(out_learnt[i])] & 31);         // (maintain an abstraction of levels involved in conflict)
+            min_level |= 1 << (vardata[var(out_learnt[i])].level & 31);         // (maintain an abstraction of levels involved in conflict)
 
         analyze_toclear.clear();
         for (i = j = 1; i < out_learnt.size(); i++)
-            if (reason[var(out_learnt[i])] == NULL || !analyze_removable(out_learnt[i], min_level))
+            if (vardata[var(out_learnt[i])].reason == GClause_NULL || !analyze_removable(out_learnt[i], min_level))
                 out_learnt[j++] = out_learnt[i];
     }else if(expensive_ccmin == 1){
         // Simplify conflict clause (a little):
         //
         analyze_toclear.clear();
         for (i = j = 1; i < out_learnt.size(); i++){
-            Clause* r = reason[var(out_learnt[i])];
-            if (r == NULL)
+            if (vardata[var(out_learnt[i])].reason == GClause_NULL)
                 out_learnt[j++] = out_learnt[i];
             else{
-                Clause& c = *r;
+                Clause& c = ca[reasonClause(var(out_learnt[i]))];
                 for (int k = 1; k < c.size(); k++)
-                    if (!seen[var(c[k])] && level[var(c[k])] != 0){
+                    if (!seen[var(c[k])] && vardata[var(c[k])].level != 0){
                         out_learnt[j++] = out_learnt[i];
                         goto Keep;
                     }
@@ -327,29 +466,142 @@ void Solver::analyze(Clause* confl, vec<Lit>& out_learnt, int& out_btlevel)
         }
     }
 
+    stats.max_literals += out_learnt.size();
+    out_learnt.shrink(i - j);
+
     // Finilize proof logging with conflict clause minimization steps:
     //
     if (proof != NULL){
-        sort(analyze_toclear, lastToFirst_lt(trail_pos));
+        // (the removed literals are resolved in reverse trail order: mark them, then walk down the trail)
+        for (int k = 0; k < analyze_toclear.size(); k++) seen[var(analyze_toclear[k])] = 3;
+        for (int t = trail.size()-1, n = 0; n < analyze_toclear.size(); t--)
+            if (seen[var(trail[t])] == 3)
+                seen[var(trail[t])] = 1, analyze_toclear[n++] = ~trail[t];
         for (int k = 0; k < analyze_toclear.size(); k++){
-            Var     v = var(analyze_toclear[k]); assert(level[v] > 0);
+            Var     v = var(analyze_toclear[k]); assert(vardata[v].level > 0);
 				Lit     l = analyze_toclear[k];
-            Clause& c = *reason[v];
+            Clause& c = ca[reasonClause(v)];
             proof->resolve(c.id(), l);
             for (int k = 1; k < c.size(); k++)
-                if (level[var(c[k])] == 0)
+                if (vardata[var(c[k])].level == 0)
                     proof->resolve(unit_id[var(c[k])], c[k]);
         }
-        proof->endChain();
     }
+
+    // Remove literals implied by the negated asserting literal through a binary clause:
+    //
+    if (expensive_ccmin == 2)
+        analyze_binMinimize(out_learnt);
+
+    if (proof != NULL) proof->endChain();
+
+    // Backtrack to the highest level left after minimization (otherwise the clause asserts too
+    // late, and a later conflict may not need a single resolution step -- no new proof clause):
+    out_btlevel = 0;
+    for (int i = 1; i < out_learnt.size(); i++)
+        out_btlevel = max(out_btlevel, vardata[var(out_learnt[i])].level);
+
     // Clean up:
     //
     for (int j = 0; j < out_learnt.size()     ; j++) seen[var(out_learnt     [j])] = 0;
     for (int j = 0; j < analyze_toclear.size(); j++) seen[var(analyze_toclear[j])] = 0;    // ('seen[]' is now cleared)
 
-    stats.max_literals += out_learnt.size();
-    out_learnt.shrink(i - j);
     stats.tot_literals += out_learnt.size();
+    out_lbd = computeLbd(out_learnt);
+}
+
+
+// A literal 'q' of the learnt clause can be dropped if '(out_learnt[0] | ~q)' is a binary clause:
+// resolving on 'q' adds no new literal. Expects 'seen[]' set for the literals of 'out_learnt'.
+//
+void Solver::analyze_binMinimize(vec<Lit>& out_learnt)
+{
+    vec<char>& seen = analyze_seen;
+    vec<Lit>&  bs   = bin_watches[index(~out_learnt[0])];
+    int        n    = 0;
+    for (int k = 0; k < bs.size(); k++){
+        Lit q = ~bs[k];
+        if (seen[var(q)] == 1 && value(q) == l_False)
+            seen[var(q)] = 2, n++;
+    }
+    if (n == 0) return;
+
+    int i, j;
+    for (i = j = 1; i < out_learnt.size(); i++){
+        Lit q = out_learnt[i];
+        if (seen[var(q)] == 2){
+            seen[var(q)] = 0;
+            if (proof != NULL) proof->resolve(binaryId(out_learnt[0], ~q), q);
+        }else
+            out_learnt[j++] = q;
+    }
+    out_learnt.shrink(i - j);
+}
+
+
+// Remove the implied literal 'c[0]' from the reason clause 'cr', which is subsumed by the current
+// resolvent in 'analyze()'. Two literals of the current decision level are watched instead.
+//
+void Solver::strengthenReason(CRef cr)
+{
+    Clause& c = ca[cr];
+    removeWatch(watches[index(~c[0])], cr);
+    removeWatch(watches[index(~c[1])], cr);
+    if (c.learnt()) stats.learnts_literals--;
+    else            stats.clauses_literals--;
+    ca.strengthen(cr, 0);
+
+    for (int i = 0, k = 0; k < 2; i++)
+        if (vardata[var(c[i])].level == decisionLevel()){
+            Lit tmp = c[i]; c[i] = c[k]; c[k] = tmp;
+            k++; }
+    watches[index(~c[0])].push(Watcher(cr, c[1]));
+    watches[index(~c[1])].push(Watcher(cr, c[0]));
+
+    if (proof != NULL){
+        // The resolvent so far is the strengthened clause:
+        ClauseId id = proof->endChain();
+        proof->beginChain(id);
+        proof->deleted(c.id());
+        c.id() = id; }
+
+    stats.otfs++;
+}
+
+
+// Literal block distance: the number of distinct (non-zero) decision levels among the literals of 'ps'.
+//
+template<class Lits>
+int Solver::computeLbd(const Lits& ps)
+{
+    int n = 0;
+    computeLbd_stamp++;
+    for (int i = 0; i < ps.size(); i++){
+        int l = vardata[var(ps[i])].level;
+        if (l > 0 && computeLbd_seen[l] != computeLbd_stamp){
+            computeLbd_seen[l] = computeLbd_stamp;
+            n++; }
+    }
+    return n;
+}
+
+
+// Mark a learnt clause used in conflict analysis and move it to a better tier if its LBD improved.
+//
+void Solver::claUpdateLbd(Clause& c)
+{
+    if (c.tier() != tier_Core){
+        int lbd = computeLbd(c);
+        if (lbd < c.lbd()){
+            c.setLbd(lbd);
+            int t = lbdTier(lbd);
+            if (t < c.tier()){
+                learnts_tier[c.tier()]--;
+                learnts_tier[t]++;
+                c.setTier(t); }
+        }
+    }
+    c.setUsed(c.tier() == tier_Core ? 2 : 1);
 }
 
 
@@ -357,17 +609,17 @@ void Solver::analyze(Clause* confl, vec<Lit>& out_learnt, int& out_btlevel)
 //
 bool Solver::analyze_removable(Lit p, uint min_level)
 {
-    assert(reason[var(p)] != NULL);
+    assert(vardata[var(p)].reason != GClause_NULL);
     analyze_stack.clear(); analyze_stack.push(p);
     int top = analyze_toclear.size();
     while (analyze_stack.size() > 0){
-        assert(reason[var(analyze_stack.last())] != NULL);
-        Clause& c = *reason[var(analyze_stack.last())];
+        assert(vardata[var(analyze_stack.last())].reason != GClause_NULL);
+        Clause& c = ca[reasonClause(var(analyze_stack.last()))];
         analyze_stack.pop();
         for (int i = 1; i < c.size(); i++){
             Lit p = c[i];
-            if (!analyze_seen[var(p)] && level[var(p)] != 0){
-                if (reason[var(p)] != NULL && ((1 << (level[var(p)] & 31)) & min_level) != 0){
+            if (!analyze_seen[var(p)] && vardata[var(p)].level != 0){
+                if (vardata[var(p)].reason != GClause_NULL && ((1 << (vardata[var(p)].level & 31)) & min_level) != 0){
                     analyze_seen[var(p)] = 1;
                     analyze_stack.push(p);
                     analyze_toclear.push(p);
@@ -388,7 +640,7 @@ bool Solver::analyze_removable(Lit p, uint min_level)
 
 /*_________________________________________________________________________________________________
 |
-|  analyzeFinal : (confl : Clause*) (skip_first : bool)  ->  [void]
+|  analyzeFinal : (confl : CRef) (skip_first : bool)  ->  [void]
 |  
 |  Description:
 |    Specialized analysis procedure to express the final conflict in terms of assumptions.
@@ -396,7 +648,7 @@ bool Solver::analyze_removable(Lit p, uint min_level)
 |    making assumptions). If 'skip_first' is TRUE, the first literal of 'confl' is  ignored (needed
 |    if conflict arose before search even started).
 |________________________________________________________________________________________________@*/
-void Solver::analyzeFinal(Clause* confl, bool skip_first)
+void Solver::analyzeFinal(CRef cr, bool skip_first)
 {
     // -- NOTE! This code is relatively untested. Please report bugs!
     conflict.clear();
@@ -405,35 +657,39 @@ void Solver::analyzeFinal(Clause* confl, bool skip_first)
         return; }
    //assert(false);
     vec<char>&     seen  = analyze_seen;
-    if (proof != NULL) proof->beginChain(confl->id());
-    for (int i = skip_first ? 1 : 0; i < confl->size(); i++){
-        Var     x = var((*confl)[i]);
-		  Lit		 l = (*confl)[i];
-        if (level[x] > 0)
-            seen[x] = 1;
+    Clause&        confl = ca[cr];
+    int            pending = 0;     // (number of marked variables not yet reached on the trail)
+    if (proof != NULL) proof->beginChain(confl.id());
+    for (int i = skip_first ? 1 : 0; i < confl.size(); i++){
+        Var     x = var(confl[i]);
+		  Lit		 l = confl[i];
+        if (vardata[x].level > 0)
+            seen[x] = 1, pending++;
         else
             if (proof != NULL) proof->resolve(unit_id[x], l);
     }
 
+    // (stops as soon as no marked variable is left, rather than walking all of the assumption levels)
     int     start = (root_level >= trail_lim.size()) ? trail.size()-1 : trail_lim[root_level];
-    for (int i = start; i >= trail_lim[0]; i--){
+    for (int i = start; i >= trail_lim[0] && pending > 0; i--){
         Var     x = var(trail[i]);
 		  Lit     l = trail[i];
         if (seen[x]){
-            Clause* r = reason[x];
-            if (r == NULL){
-                assert(level[x] > 0);
+            if (vardata[x].reason == GClause_NULL){
+                assert(vardata[x].level > 0);
                 conflict.push(~trail[i]);
             }else{
-                Clause& c = *r;
+                Clause& c = ca[reasonClause(x)];
                 if (proof != NULL) proof->resolve(c.id(), l);
                 for (int j = 1; j < c.size(); j++)
-                    if (level[var(c[j])] > 0)
-                        seen[var(c[j])] = 1;
-                    else
+                    if (vardata[var(c[j])].level > 0){
+                        if (!seen[var(c[j])])
+                            seen[var(c[j])] = 1, pending++;
+                    }else
                         if (proof != NULL) proof->resolve(unit_id[var(c[j])], c[j]);
             }
             seen[x] = 0;
+            pending--;
         }
     }
     if (proof != NULL) conflict_id = proof->endChain();
@@ -442,7 +698,7 @@ void Solver::analyzeFinal(Clause* confl, bool skip_first)
 
 /*_________________________________________________________________________________________________
 |
-|  enqueue : (p : Lit) (from : Clause*)  ->  [bool]
+|  enqueue : (p : Lit) (from : GClause) (level : int)  ->  [bool]
 |  
 |  Description:
 |    Puts a new fact on the propagation queue as well as immediately updating the variable's value.
@@ -450,22 +706,23 @@ void Solver::analyzeFinal(Clause* confl, bool skip_first)
 |  
 |  Input:
 |    p    - The fact to enqueue
-|    from - [Optional] Fact propagated from this (currently) unit clause. Stored in 'reason[]'.
-|           Default value is NULL (no reason).
+|    from - [Optional] Fact propagated from this (currently) unit clause. Stored in 'vardata[]'.
+|           Default value is GClause_NULL (no reason). A binary clause is given by its other literal.
+|    level - [Optional] Decision level of the assignment, if lower than the current one (the highest
+|           level of the other literals of 'from'). Default value -1 means 'decisionLevel()'.
 |  
 |  Output:
 |    TRUE if fact was enqueued without conflict, FALSE otherwise.
 |________________________________________________________________________________________________@*/
-bool Solver::enqueue(Lit p, Clause* from)
+bool Solver::enqueue(Lit p, GClause from, int level)
 {
     if (value(p) != l_Undef)
         return value(p) != l_False;
     else{
         Var     x = var(p);
         assigns  [x] = toInt(lbool(!sign(p)));
-        level    [x] = decisionLevel();
-        trail_pos[x] = trail.size();
-        reason   [x] = from;
+        vardata  [x].reason = from;
+        vardata  [x].level  = (level < 0) ? decisionLevel() : level;
         trail.push(p);
         return true;
     }
@@ -475,28 +732,59 @@ bool Solver::enqueue(Lit p, Clause* from)
 
 /*_________________________________________________________________________________________________
 |
-|  propagate : [void]  ->  [Clause*]
+|  propagate : [void]  ->  [CRef]
 |  
 |  Description:
 |    Propagates all enqueued facts. If a conflict arises, the conflicting clause is returned,
-|    otherwise NULL. NOTE! This method has been optimized for speed rather than readability.
+|    otherwise CRef_Undef. NOTE! This method has been optimized for speed rather than readability.
 |  
 |    Post-conditions:
 |      * The propagation queue is empty, even if there was a conflict.
 |________________________________________________________________________________________________@*/
-Clause* Solver::propagate()
+CRef Solver::propagate()
 {
-    Clause* confl = NULL;
+    CRef    confl = CRef_Undef;
     while (qhead < trail.size()){
         stats.propagations++;
         simpDB_props--;
 
         Lit            p  = trail[qhead++];     // 'p' is enqueued fact to propagate.
-        vec<Clause*>&  ws = watches[index(p)];
-        Clause**       i,** j,** end;
+        int            p_level = (chrono_lim > 0) ? vardata[var(p)].level : decisionLevel();
+        bool           lower   = p_level < decisionLevel();    // (only after chronological backtracking)
+
+        // Propagate binary clauses first (no clause needs to be inspected):
+        vec<Lit>&      bs = bin_watches[index(p)];
+        for (int k = 0; k < bs.size(); k++){
+            Lit q = bs[k];
+            if (value(q) == l_True) continue;
+
+            if (decisionLevel() == 0 && proof != NULL){
+                Clause& c = ca[propagate_tmpbin];
+                c[0] = q; c[1] = ~p; c.id() = bin_ids[index(p)][k];
+                logUnit(c); }
+
+            if (!enqueue(q, GClause_new(~p), p_level)){
+                if (decisionLevel() == 0)
+                    ok = false;
+                Clause& c = ca[propagate_tmpbin];
+                c[0] = q; c[1] = ~p;
+                if (proof != NULL) c.id() = bin_ids[index(p)][k];
+                qhead = trail.size();
+                return propagate_tmpbin;
+            }
+        }
+
+        vec<Watcher>&  ws = watches[index(p)];
+        Watcher        *i, *j, *end;
+
+        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+            // Try to avoid inspecting the clause:
+            Lit blocker = i->blocker;
+            if (value(blocker) == l_True){
+                *j++ = *i++; continue; }
 
-        for (i = j = (Clause**)ws, end = i + ws.size();  i != end;){
-            Clause& c = **i; i++;
+            CRef    cr = i->cref;
+            Clause& c  = ca[cr]; i++;
             // Make sure the false literal is data[1]:
             Lit false_lit = ~p;
             if (c[0] == false_lit)
@@ -505,41 +793,43 @@ Clause* Solver::propagate()
             assert(c[1] == false_lit);
 
             // If 0th watch is true, then clause is already satisfied.
-            Lit   first = c[0];
-            lbool val   = value(first);
-            if (val == l_True){
-                *j++ = &c;
+            Lit     first = c[0];
+            Watcher w(cr, first);
+            lbool   val   = value(first);
+            if (first != blocker && val == l_True){
+                *j++ = w;
             }else{
                 // Look for new watch:
                 for (int k = 2; k < c.size(); k++)
                     if (value(c[k]) != l_False){
                         c[1] = c[k]; c[k] = false_lit;
-                        watches[index(~c[1])].push(&c);
+                        watches[index(~c[1])].push(w);
                         goto FoundWatch; }
 
                 // Did not find watch -- clause is unit under assignment:
-                if (decisionLevel() == 0 && proof != NULL){
-                    // Log the production of this unit clause:
-                    proof->beginChain(c.id());
-                    for (int k = 1; k < c.size(); k++)
-                        proof->resolve(unit_id[var(c[k])], c[k]);
-                    ClauseId id = proof->endChain();
-                    assert(unit_id[var(first)] == ClauseId_NULL || value(first) == l_False);    // (if variable already has 'id', it must be with the other polarity and we should have derived the empty clause here)
-                    if (value(first) != l_False)
-                        unit_id[var(first)] = id;
-                    else{
-                        // Empty clause derived:
-                        proof->beginChain(unit_id[var(first)]);
-                        proof->resolve(id, ~first);
-                        proof->endChain();
-                    }
-                }
-					 
-                *j++ = &c;
-                if (!enqueue(first, &c)){
+                if (decisionLevel() == 0 && proof != NULL)
+                    logUnit(c);
+
+                int level;
+                if (lower){
+                    // Below the current level: watch the false literal of the highest level instead
+                    // of 'false_lit' (the watches must not both be false once backtracking undoes it):
+                    int max_k = 1;
+                    for (int k = 2; k < c.size(); k++)
+                        if (vardata[var(c[k])].level > vardata[var(c[max_k])].level)
+                            max_k = k;
+                    if (max_k != 1){
+                        c[1] = c[max_k]; c[max_k] = false_lit;
+                        watches[index(~c[1])].push(w);
+                    }else
+                        *j++ = w;
+                    level = vardata[var(c[1])].level;
+                }else
+                    *j++ = w, level = decisionLevel();
+                if (!enqueue(first, GClause_new(cr), level)){
                     if (decisionLevel() == 0)
                         ok = false;
-                    confl = &c;
+                    confl = cr;
                     qhead = trail.size();
                     // Copy the remaining watches:
                     while (i < end)
@@ -549,40 +839,174 @@ Clause* Solver::propagate()
             }
         }
         ws.shrink(i - j);
+        if (confl != CRef_Undef) break;
+
+        // Propagate the XOR constraints watching 'var(p)':
+        vec<CRef>&     xs = xor_watches[var(p)];
+        int            xi, xj;
+        for (xi = xj = 0; xi < xs.size(); xi++){
+            CRef    cr = xs[xi];
+            Clause& c  = ca[cr];
+            if (vardata[var(p)].reason == GClause_new(cr)){     // ('p' was implied by this constraint, all of it is assigned)
+                xs[xj++] = cr; continue; }
+
+            // Make sure the variable of 'p' is the one of 'c[1]', and look for a new one to watch:
+            if (var(c[0]) == var(p)){
+                Lit tmp = c[0]; c[0] = c[1]; c[1] = tmp; }
+            for (int k = 2; k < c.size(); k++)
+                if (value(c[k]) == l_Undef){
+                    Lit tmp = c[1]; c[1] = c[k]; c[k] = tmp;
+                    xor_watches[var(c[1])].push(cr);
+                    goto FoundXorWatch; }
+
+            // All but 'c[0]' are assigned. Negate the true literals together with 'c[0]' (which
+            // keeps the XOR) to read it as the clause of the current assignment:
+            for (int k = 1; k < c.size(); k++)
+                if (value(c[k]) == l_True)
+                    c[k] = ~c[k], c[0] = ~c[0];
+            int level;
+            if (lower){
+                // (as for clauses: the variable of the highest level is watched instead of 'var(p)')
+                int max_k = 1;
+                for (int k = 2; k < c.size(); k++)
+                    if (vardata[var(c[k])].level > vardata[var(c[max_k])].level)
+                        max_k = k;
+                if (max_k != 1){
+                    Lit tmp = c[1]; c[1] = c[max_k]; c[max_k] = tmp;
+                    xor_watches[var(c[1])].push(cr);
+                }else
+                    xs[xj++] = cr;
+                level = vardata[var(c[1])].level;
+            }else
+                xs[xj++] = cr, level = decisionLevel();
+            if (value(c[0]) == l_True)
+                continue;
+            if (!enqueue(c[0], GClause_new(cr), level)){
+                if (decisionLevel() == 0)
+                    ok = false;
+                confl = cr;
+                qhead = trail.size();
+                while (++xi < xs.size())
+                    xs[xj++] = xs[xi];
+                break;
+            }
+          FoundXorWatch:;
+        }
+        xs.shrink(xi - xj);
     }
 
     return confl;
 }
 
 
+// Log the production of the unit clause 'c[0]' at the top-level ('c[1..]' are all false).
+//
+void Solver::logUnit(Clause& c)
+{
+    Lit first = c[0];
+    proof->beginChain(c.id());
+    for (int k = 1; k < c.size(); k++)
+        proof->resolve(unit_id[var(c[k])], c[k]);
+    ClauseId id = proof->endChain();
+    assert(value(first) != l_True);     // (if variable is false and has an 'id', we have derived the empty clause here; an 'id' of an unassigned variable is left from a unit learnt under assumptions, which is undone by backtracking)
+    if (value(first) != l_False)
+        unit_id[var(first)] = id;
+    else{
+        // Empty clause derived:
+        proof->beginChain(unit_id[var(first)]);
+        proof->resolve(id, ~first);
+        proof->endChain();
+    }
+}
+
+
+// Returns the clause that implied the current value of 'x' (or CRef_Undef). A binary reason is
+// expanded into 'analyze_tmpbin' with the implied literal first; it is only valid until the next call.
+//
+CRef Solver::reasonClause(Var x)
+{
+    GClause r = vardata[x].reason;
+    if (!r.isLit())
+        return r.clause();
+
+    Clause& c = ca[analyze_tmpbin];
+    c[0] = Lit(x, value(x) == l_False);
+    c[1] = r.lit();
+    if (proof != NULL) c.id() = binaryId(c[0], c[1]);
+    return analyze_tmpbin;
+}
+
+
+// (In proof logging mode only.) Returns the ID of the binary clause '{p, q}'.
+//
+ClauseId Solver::binaryId(Lit p, Lit q)
+{
+    vec<Lit>& bs = bin_watches[index(~p)];
+    for (int k = 0; k < bs.size(); k++)
+        if (bs[k] == q)
+            return bin_ids[index(~p)][k];
+    assert(false);
+    return ClauseId_NULL;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  reduceDB : ()  ->  [void]
 |  
 |  Description:
-|    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
-|    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+|    Reduce the learnt clauses tier by tier:
+|      * Core clauses (LBD <= 'core_lbd') are not removed. They carry over from pattern to pattern
+|        and only drop to the mid tier after two reductions without taking part in a conflict.
+|      * Mid-tier clauses (LBD <= 'mid_lbd') are not removed either, but drop to the local tier
+|        after one reduction without use.
+|      * Half of the local clauses (the least active ones) are removed, minus the clauses locked by
+|        the current assignment. Locked clauses are clauses that are reason to some assignment.
+|    A clause whose LBD improves when it is used moves up again ('claUpdateLbd()'). Binary clauses
+|    are not stored in 'learnts' and are never removed.
 |________________________________________________________________________________________________@*/
-struct reduceDB_lt { bool operator () (Clause* x, Clause* y) { return x->size() > 2 && (y->size() == 2 || x->activity() < y->activity()); } };
+struct reduceDB_lt {
+    ClauseAllocator& ca;
+    reduceDB_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) {
+        return ca[x].tier() == tier_Local && (ca[y].tier() != tier_Local || ca[x].activity() < ca[y].activity()); } };
 void Solver::reduceDB()
 {
     int     i, j;
-    double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
+    int     n_local   = learnts_tier[tier_Local];
+    double  extra_lim = cla_inc / n_local;      // Remove any local clause below this activity
 
-    sort(learnts, reduceDB_lt());
-    for (i = j = 0; i < learnts.size() / 2; i++){
-        if (learnts[i]->size() > 2 && !locked(learnts[i]))
+    sort(learnts, reduceDB_lt(ca));             // (local clauses first)
+    for (i = j = 0; i < n_local / 2; i++){
+        if (!locked(learnts[i]))
             remove(learnts[i]);
         else
             learnts[j++] = learnts[i];
     }
-    for (; i < learnts.size(); i++){
-        if (learnts[i]->size() > 2 && !locked(learnts[i]) && learnts[i]->activity() < extra_lim)
+    for (; i < n_local; i++){
+        if (!locked(learnts[i]) && ca[learnts[i]].activity() < extra_lim)
             remove(learnts[i]);
         else
             learnts[j++] = learnts[i];
     }
+    for (; i < learnts.size(); i++)
+        learnts[j++] = learnts[i];
     learnts.shrink(i - j);
+
+    // Age the core and mid-tier clauses; those that ran out of uses move down one tier:
+    for (i = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        if (c.tier() == tier_Local) continue;
+        if (c.used() > 0)
+            c.setUsed(c.used() - 1);
+        else{
+            learnts_tier[c.tier()]--;
+            c.setTier(c.tier() + 1);
+            learnts_tier[c.tier()]++;
+            if (c.tier() == tier_Mid) c.setUsed(1); }
+    }
+
+    checkGarbage();
 }
 
 
@@ -591,31 +1015,90 @@ void Solver::reduceDB()
 |  simplifyDB : [void]  ->  [bool]
 |  
 |  Description:
-|    Simplify the clause database according to the current top-level assigment. Currently, the only
-|    thing done here is the removal of satisfied clauses, but more things can be put here.
+|    Simplify the clause database according to the current top-level assigment: remove satisfied
+|    clauses, and every 'subsume_interval' conflicts (or a tenth as many new top-level facts) the
+|    subsumed ones as well (see 'subsume()').
 |________________________________________________________________________________________________@*/
 void Solver::simplifyDB()
 {
     if (!ok) return;    // GUARD (public method)
     assert(decisionLevel() == 0);
 
-    if (propagate() != NULL){
+    if (propagate() != CRef_Undef){
         ok = false;
         return; }
 
-    if (nAssigns() == simpDB_assigns || simpDB_props > 0)   // (nothing has changed or preformed a simplification too recently)
+    bool    subsume_due = stats.conflicts >= subsume_conflicts || nAssigns() >= subsume_assigns;
+    if ((nAssigns() == simpDB_assigns || simpDB_props > 0) && !subsume_due)   // (nothing has changed or preformed a simplification too recently)
         return;
 
+    // Add the XOR constraints on assigned variables again without them (may give new units):
+    vec<CRef>   redo;
+    int         n = 0;
+    for (int i = 0; i < xors.size(); i++){
+        const Clause& c = ca[xors[i]];
+        bool          assigned = false;
+        for (int k = 0; k < c.size() && !assigned; k++)
+            assigned = value(c[k]) != l_Undef;
+        if (assigned)
+            redo.push(xors[i]);
+        else
+            xors[n++] = xors[i];
+    }
+    xors.shrink(xors.size() - n);
+    vec<Lit>    lits;
+    for (int i = 0; i < redo.size(); i++){
+        const Clause& c = ca[redo[i]];
+        lits.clear();
+        for (int k = 0; k < c.size(); k++)
+            lits.push(c[k]);
+        if (locked(redo[i]))
+            vardata[var(c[0])].reason = GClause_NULL;   // (a top-level fact; XOR constraints are not used when logging proofs)
+        removeXor(redo[i]);
+        newXor(lits);
+    }
+    if (!ok || propagate() != CRef_Undef){
+        ok = false;
+        return; }
+
+    if (subsume_due){
+        subsume();
+        if (!ok) return;
+        subsume_conflicts = stats.conflicts + subsume_interval;
+        subsume_assigns   = nAssigns() + subsume_interval / 10; }
+
     // Clear watcher lists:
+    int     bin_removed = 0;
     for (int i = simpDB_assigns; i < nAssigns(); i++){
         Lit p = trail[i];
         watches[index( p)].clear(true);
         watches[index(~p)].clear(true);
+        bin_removed += bin_watches[index(p)].size() + bin_watches[index(~p)].size();
+        bin_watches[index( p)].clear(true);
+        bin_watches[index(~p)].clear(true);
+        if (proof != NULL) bin_ids[index(p)].clear(true), bin_ids[index(~p)].clear(true);
+    }
+
+    // Remove satisfied binary clauses (the other half of their implication list entries is gone already):
+    for (int i = 0; i < bin_watches.size(); i++){
+        vec<Lit>& bs = bin_watches[i];
+        int       j  = 0;
+        for (int k = 0; k < bs.size(); k++){
+            if (value(bs[k]) != l_True){
+                if (proof != NULL) bin_ids[i][j] = bin_ids[i][k];
+                bs[j++] = bs[k]; }
+        }
+        bin_removed += bs.size() - j;
+        bs.shrink(bs.size() - j);
+        if (proof != NULL) bin_ids[i].shrink(bin_ids[i].size() - j);
     }
+    assert(bin_removed % 2 == 0);
+    n_bin_clauses          -= bin_removed / 2;
+    stats.clauses_literals -= bin_removed;
 
     // Remove satisfied clauses:
     for (int type = 0; type < 2; type++){
-        vec<Clause*>& cs = type ? learnts : clauses;
+        vec<CRef>&    cs = type ? learnts : clauses;
         int           j  = 0;
         for (int i = 0; i < cs.size(); i++){
             if (!locked(cs[i]) && simplify(cs[i]))
@@ -626,11 +1109,1267 @@ void Solver::simplifyDB()
         cs.shrink(cs.size()-j);
     }
 
+    checkGarbage();
+
     simpDB_assigns = nAssigns();
     simpDB_props   = stats.clauses_literals + stats.learnts_literals;   // (shouldn't depend on 'stats' really, but it will do for now)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  subsume : [void]  ->  [void]
+|  
+|  Description:
+|    Remove the clauses subsumed by another clause, and strengthen the clauses that contain another
+|    one but for a single negated literal (self-subsuming resolution: 'D | ~p' and 'C | p', with 'D'
+|    a subset of 'C', give 'C'). Binary clauses are looked up in 'bin_watches'; longer subsuming
+|    clauses in occurrence lists (per variable, for both uses), with 64-bit signatures of the
+|    variables to rule out most pairs early. Problem and learnt clauses are both covered, but a
+|    problem clause is never removed for a learnt one (which may be deleted later). Satisfied and
+|    locked clauses are left to 'simplifyDB()'.
+|________________________________________________________________________________________________@*/
+static inline uint64 abstractVars(const Clause& c)
+{
+    uint64 sig = 0;
+    for (int i = 0; i < c.size(); i++)
+        sig |= (uint64)1 << (var(c[i]) & 63);
+    return sig;
+}
+
+void Solver::subsume()
+{
+    assert(decisionLevel() == 0);
+
+    // Candidates, with their signatures and occurrence lists:
+    vec<CRef>       cands;
+    vec<uint64>     sig;
+    vec<vec<int> >  occ(nVars());
+    for (int type = 0; type < 2; type++){
+        const vec<CRef>& cs = type ? learnts : clauses;
+        for (int i = 0; i < cs.size(); i++)
+            if (!simplify(cs[i])){
+                const Clause& c = ca[cs[i]];
+                for (int k = 0; k < c.size(); k++)
+                    occ[var(c[k])].push(cands.size());
+                cands.push(cs[i]);
+                sig.push(abstractVars(c)); }
+    }
+    vec<char>       gone(cands.size(), 0);
+    vec<char>&      seen = subsume_seen;
+    seen.growTo(2*nVars(), 0);
+
+    // By binary clauses ('x | y' with 'x' in the clause):
+    for (int i = 0; i < cands.size() && ok; i++){
+        for (bool again = true; again && !gone[i];){
+            again = false;
+            const Clause& c   = ca[cands[i]];
+            bool          sub = false;
+            Lit           p   = lit_Undef;
+            ClauseId      by  = ClauseId_NULL;
+            for (int k = 0; k < c.size(); k++)
+                seen[index(c[k])] = 1;
+            for (int k = 0; k < c.size() && !sub && p == lit_Undef; k++){
+                const vec<Lit>& bs = bin_watches[index(~c[k])];
+                if (bs.size() > subsume_occ_lim) continue;
+                for (int m = 0; m < bs.size(); m++)
+                    if (seen[index(bs[m])]){
+                        sub = true; break;
+                    }else if (seen[index(~bs[m])]){
+                        p  = ~bs[m];
+                        by = (proof != NULL) ? bin_ids[index(~c[k])][m] : ClauseId_NULL;
+                        break; }
+            }
+            for (int k = 0; k < c.size(); k++)
+                seen[index(c[k])] = 0;
+
+            if (sub){
+                remove(cands[i]);
+                gone[i] = 1;
+                stats.subsumed++;
+            }else if (p != lit_Undef && !simplify(cands[i])){
+                if (strengthenBy(cands[i], p, by))
+                    gone[i] = 1;
+                else
+                    sig[i] = abstractVars(ca[cands[i]]), again = true;
+            }
+        }
+    }
+
+    // By longer clauses (tried again once they are strengthened):
+    vec<int>    queue;
+    for (int i = 0; i < cands.size(); i++)
+        queue.push(i);
+    for (int qi = 0; qi < queue.size() && ok; qi++){
+        int d = queue[qi];
+        if (gone[d] || simplify(cands[d])) continue;
+
+        const Clause& cd   = ca[cands[d]];
+        Var           best = var(cd[0]);
+        for (int k = 1; k < cd.size(); k++)
+            if (occ[var(cd[k])].size() < occ[best].size())
+                best = var(cd[k]);
+        if (occ[best].size() > subsume_occ_lim) continue;
+
+        for (int k = 0; k < cd.size(); k++)
+            seen[index(cd[k])] = 1;
+        const vec<int>& os = occ[best];
+        for (int j = 0; j < os.size() && ok; j++){
+            int c = os[j];
+            if (c == d || gone[c] || ca[cands[c]].size() < cd.size() || (sig[d] & ~sig[c]) != 0)
+                continue;
+
+            const Clause& cc   = ca[cands[c]];
+            int           hits = 0, flips = 0;
+            Lit           p    = lit_Undef;
+            for (int k = 0; k < cc.size(); k++)
+                if (seen[index(cc[k])])
+                    hits++;
+                else if (seen[index(~cc[k])])
+                    flips++, p = cc[k];
+
+            if (hits == cd.size()){
+                if ((cc.learnt() || !cd.learnt()) && !simplify(cands[c])){
+                    remove(cands[c]);
+                    gone[c] = 1;
+                    stats.subsumed++; }
+            }else if (hits == cd.size() - 1 && flips == 1 && !simplify(cands[c])){
+                if (strengthenBy(cands[c], p, (proof != NULL) ? cd.id() : ClauseId_NULL))
+                    gone[c] = 1;
+                else{
+                    sig[c] = abstractVars(ca[cands[c]]);
+                    queue.push(c); }
+            }
+        }
+        for (int k = 0; k < cd.size(); k++)
+            seen[index(cd[k])] = 0;
+    }
+
+    // Drop the removed clauses from the lists (the candidates are in the same order):
+    int     n = 0;
+    for (int type = 0; type < 2; type++){
+        vec<CRef>&    cs = type ? learnts : clauses;
+        int           j  = 0;
+        for (int i = 0; i < cs.size(); i++){
+            if (n < cands.size() && cands[n] == cs[i]){
+                if (gone[n++]) continue; }
+            cs[j++] = cs[i];
+        }
+        cs.shrink(cs.size()-j);
+    }
+
+    if (ok && propagate() != CRef_Undef)
+        ok = false;
+}
+
+
+// Remove 'p' from the clause 'cr' by resolution with the clause 'by' (containing '~p' and a subset
+// of the others), together with its literals false at the top level. A clause left with two
+// literals or less is replaced by a binary clause or a unit (not propagated), and TRUE is returned.
+//
+bool Solver::strengthenBy(CRef cr, Lit p, ClauseId by)
+{
+    Clause& c    = ca[cr];
+    int     size = c.size();
+    removeWatch(watches[index(~c[0])], cr);
+    removeWatch(watches[index(~c[1])], cr);
+    if (proof != NULL){
+        proof->beginChain(c.id());
+        proof->resolve(by, p); }
+    for (int k = c.size()-1; k >= 0; k--)
+        if (c[k] == p || value(c[k]) == l_False){
+            if (proof != NULL && c[k] != p)
+                proof->resolve(unit_id[var(c[k])], c[k]);
+            ca.strengthen(cr, k); }
+    ClauseId id = (proof != NULL) ? proof->endChain() : ClauseId_NULL;
+    stats.strengthened++;
+
+    if (c.size() > 2){
+        if (c.learnt()) stats.learnts_literals -= size - c.size();
+        else            stats.clauses_literals -= size - c.size();
+        if (proof != NULL){
+            proof->deleted(c.id());
+            c.id() = id; }
+        watches[index(~c[0])].push(Watcher(cr, c[1]));
+        watches[index(~c[1])].push(Watcher(cr, c[0]));
+        return false; }
+
+    Lit     a = (c.size() > 0) ? c[0] : lit_Undef;
+    Lit     b = (c.size() > 1) ? c[1] : lit_Undef;
+    if (c.learnt()) stats.learnts_literals -= size, learnts_tier[c.tier()]--;
+    else            stats.clauses_literals -= size;
+    if (proof != NULL) proof->deleted(c.id());
+    remove(cr, true);
+
+    if (a == lit_Undef)
+        ok = false;
+    else if (b == lit_Undef){
+        if (proof != NULL) unit_id[var(a)] = id;
+        check(enqueue(a));
+    }else{
+        bin_watches[index(~a)].push(b);
+        bin_watches[index(~b)].push(a);
+        if (proof != NULL){
+            bin_ids[index(~a)].push(id);
+            bin_ids[index(~b)].push(id); }
+        n_bin_clauses++;
+        stats.clauses_literals += 2;
+    }
+    return true;
+}
+
+// Collect the clause region if enough of it is taken up by removed clauses.
+//
+void Solver::checkGarbage()
+{
+    if (ca.wasted() > ca.size() * garbage_frac)
+        garbageCollect();
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  garbageCollect : [void]  ->  [void]
+|  
+|  Description:
+|    Move all live clauses into a fresh region, dropping the space of removed ones. Clauses are
+|    moved in the order of the watcher lists, so that the clauses visited when a literal is
+|    propagated end up next to each other.
+|________________________________________________________________________________________________@*/
+void Solver::garbageCollect()
+{
+    ClauseAllocator to(ca.size() - ca.wasted());
+    relocAll(to);
+    if (verbosity >= 2)
+        reportf("|  Garbage collection:   %12d words => %12d words             |\n", (int)ca.size(), (int)to.size());
+    to.moveTo(ca);
+}
+
+void Solver::relocAll(ClauseAllocator& to)
+{
+    // All watchers:
+    for (int i = 0; i < watches.size(); i++){
+        vec<Watcher>& ws = watches[i];
+        for (int j = 0; j < ws.size(); j++)
+            ca.reloc(ws[j].cref, to);
+    }
+
+    // All reasons:
+    for (int i = 0; i < trail.size(); i++){
+        Var     v = var(trail[i]);
+        GClause r = vardata[v].reason;
+        if (r != GClause_NULL && !r.isLit()){
+            CRef cr = r.clause();
+            ca.reloc(cr, to);
+            vardata[v].reason = GClause_new(cr); }
+    }
+
+    // All clauses (those without watchers are locked clauses on the top-level):
+    for (int i = 0; i < learnts.size(); i++) ca.reloc(learnts[i], to);
+    for (int i = 0; i < clauses.size(); i++) ca.reloc(clauses[i], to);
+
+    // All XOR constraints:
+    for (int i = 0; i < xor_watches.size(); i++){
+        vec<CRef>& xs = xor_watches[i];
+        for (int j = 0; j < xs.size(); j++)
+            ca.reloc(xs[j], to);
+    }
+    for (int i = 0; i < xors.size(); i++) ca.reloc(xors[i], to);
+    ca.reloc(propagate_tmpbin, to);
+    ca.reloc(analyze_tmpbin  , to);
+}
+
+
+//=================================================================================================
+// Variable elimination:
+
+
+struct ElimCost_lt {
+    const vec<int64>&   cost;
+    bool operator () (Var x, Var y) { return cost[x] < cost[y]; }
+    ElimCost_lt(const vec<int64>& c) : cost(c) { }
+};
+
+/*_________________________________________________________________________________________________
+|
+|  eliminate : [void]  ->  [bool]
+|  
+|  Description:
+|    Bounded variable elimination (as in SatELite). A variable is removed by replacing the clauses
+|    containing it with their non-tautological resolvents on it, if that does not increase the
+|    number of clauses and no resolvent is longer than 'elim_clause_lim'. Variables with more than
+|    'elim_resolve_lim' pairs of clauses to resolve are kept (they rarely pass, and every try
+|    touches many neighbours to be tried again). Variables are tried with the fewest possible
+|    resolvents first, and again when their occurrences change, until nothing more can be
+|    eliminated. Learnt clauses on eliminated variables are removed. XOR constraints are recovered
+|    from the clauses first (see 'recoverXors()'); their variables are not eliminated.
+|  
+|    Call at the top level once the problem is added. Variables that will be assumed or used in
+|    clauses added later must be frozen first ('setFrozen()'). Eliminated variables still get a
+|    value in 'model' (see 'extendModel()'). Does nothing when logging proofs (the resolvents
+|    would have to be logged as chains).
+|  
+|  Output:
+|    FALSE if the problem was found unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::eliminate()
+{
+    if (!ok || proof != NULL) return ok;
+    assert(decisionLevel() == 0);
+
+    simpDB_props = 0;       // (remove the satisfied clauses first, whatever was done recently)
+    simplifyDB();
+    if (!xors_recovered) recoverXors();
+    if (!ok) return false;
+
+    // The variables of XOR constraints are kept (they have no occurrence lists):
+    vec<char>   in_xor(nVars(), 0);
+    for (int i = 0; i < xors.size(); i++){
+        const Clause& c = ca[xors[i]];
+        for (int k = 0; k < c.size(); k++)
+            in_xor[var(c[k])] = 1;
+    }
+
+    // Occurrence lists (binary clauses are found in 'bin_watches'):
+    occurs .growTo(2*nVars());
+    touched.growTo(nVars(), 1);
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        for (int j = 0; j < c.size(); j++)
+            occurs[index(c[j])].push(clauses[i]);
+    }
+
+    vec<Var>    cands;
+    vec<int64>  cost(nVars(), 0);
+    for (bool progress = true; progress && ok;){
+        progress = false;
+        cands.clear();
+        for (Var x = 0; x < nVars(); x++){
+            if (touched[x] && value(x) == l_Undef && !frozen[x] && !eliminated[x] && !in_xor[x]){
+                Lit p = Lit(x);
+                cost[x] = (int64)(occurs[index(p)].size() + bin_watches[index(~p)].size()) * (occurs[index(~p)].size() + bin_watches[index(p)].size());
+                cands.push(x); }
+            touched[x] = 0;
+        }
+        sort(cands, ElimCost_lt(cost));
+        for (int i = 0; i < cands.size() && ok; i++)
+            if (value(cands[i]) == l_Undef && eliminateVar(cands[i]))
+                progress = true;
+    }
+    occurs .clear(true);
+    touched.clear(true);
+
+    // Drop the removed problem clauses from 'clauses', and remove the learnt clauses on eliminated variables:
+    for (int type = 0; type < 2; type++){
+        vec<CRef>&    cs = type ? learnts : clauses;
+        int           j  = 0;
+        for (int i = 0; i < cs.size(); i++){
+            const Clause& c    = ca[cs[i]];
+            bool          gone = false;
+            for (int k = 0; k < c.size() && !gone; k++)
+                gone = eliminated[var(c[k])];
+            if (!gone)
+                cs[j++] = cs[i];
+            else if (type)
+                remove(cs[i]);
+        }
+        cs.shrink(cs.size()-j);
+    }
+
+    // Forget the gates that lost their output or an input:
+    for (Var x = 0; x < nVars(); x++)
+        if (gates[x].type != gate_None && (eliminated[x] || eliminated[var(gates[x].a)] || eliminated[var(gates[x].b)]))
+            gates[x] = Gate();
+
+    checkGarbage();
+    return ok;
+}
+
+
+// Eliminate 'v' if the resolvents are few and short enough (see 'eliminate()'). Returns TRUE if
+// it was eliminated.
+//
+bool Solver::eliminateVar(Var v)
+{
+    Lit         p         = Lit(v);
+    vec<Lit>&   pos       = eliminateVar_pos;
+    vec<Lit>&   neg       = eliminateVar_neg;
+    vec<Lit>&   resolvent = eliminateVar_resolvent;
+    pos.clear();
+    neg.clear();
+    int         n_pos     = collectClauses( p, pos);
+    int         n_neg     = collectClauses(~p, neg);
+    if ((int64)n_pos * n_neg > elim_resolve_lim)
+        return false;
+
+    // Count the resolvents:
+    int         cnt       = 0;
+    for (int i = 0; i < pos.size(); i++){
+        for (int j = 0; j < neg.size(); j++){
+            if (merge(&pos[i], &neg[j], resolvent) && (++cnt > n_pos + n_neg || resolvent.size() > elim_clause_lim))
+                return false;
+            while (neg[j] != lit_Undef) j++;
+        }
+        while (pos[i] != lit_Undef) i++;
+    }
+
+    // Keep the clauses of one polarity (the fewer) for 'extendModel()', followed by the default
+    // value of 'v' (which is read first):
+    const vec<Lit>& kept = (n_pos <= n_neg) ? pos : neg;
+    Lit             q    = (n_pos <= n_neg) ? p   : ~p;
+    for (int i = 0; i < kept.size(); i++){
+        int start = elim_clauses.size();
+        elim_clauses.push(index(q));
+        for (; kept[i] != lit_Undef; i++)
+            elim_clauses.push(index(kept[i]));
+        elim_clauses.push(elim_clauses.size() - start);
+    }
+    elim_clauses.push(index(~q));
+    elim_clauses.push(1);
+
+    eliminated[v] = 1;
+    n_eliminated++;
+    setDecisionVar(v, false);
+    removeClauses( p);
+    removeClauses(~p);
+
+    // Add the resolvents:
+    int         trail_start = trail.size();
+    for (int i = 0; i < pos.size() && ok; i++){
+        for (int j = 0; j < neg.size() && ok; j++){
+            if (merge(&pos[i], &neg[j], resolvent)){
+                int n = clauses.size();
+                addClause(resolvent);
+                if (clauses.size() > n){
+                    CRef          cr = clauses.last();
+                    const Clause& c  = ca[cr];
+                    for (int k = 0; k < c.size(); k++)
+                        occurs[index(c[k])].push(cr);
+                }
+                for (int k = 0; k < resolvent.size(); k++)
+                    touched[var(resolvent[k])] = 1;
+            }
+            while (neg[j] != lit_Undef) j++;
+        }
+        while (pos[i] != lit_Undef) i++;
+    }
+    if (ok && trail.size() > trail_start && propagate() != CRef_Undef)
+        ok = false;
+
+    return true;
+}
+
+
+// Append the problem clauses containing 'p' that are not satisfied to 'out', each without 'p' and
+// its false literals, and terminated by 'lit_Undef'. Returns the number of clauses.
+//
+int Solver::collectClauses(Lit p, vec<Lit>& out)
+{
+    int              n  = 0;
+    const vec<Lit>&  bs = bin_watches[index(~p)];
+    for (int i = 0; i < bs.size(); i++)
+        if (value(bs[i]) != l_True){
+            out.push(bs[i]);
+            out.push(lit_Undef);
+            n++; }
+
+    const vec<CRef>& cs = occurs[index(p)];
+    for (int i = 0; i < cs.size(); i++){
+        const Clause& c     = ca[cs[i]];
+        int           start = out.size();
+        bool          sat   = false;
+        for (int k = 0; k < c.size() && !sat; k++){
+            if (value(c[k]) == l_True)
+                sat = true;
+            else if (c[k] != p && value(c[k]) == l_Undef)
+                out.push(c[k]);
+        }
+        if (sat)
+            out.shrink(out.size() - start);
+        else
+            out.push(lit_Undef), n++;
+    }
+    return n;
+}
+
+
+// Resolvent of two clauses given by their other literals ('lit_Undef' terminated, as collected by
+// 'collectClauses()'). Returns FALSE if it is a tautology.
+//
+bool Solver::merge(const Lit* a, const Lit* b, vec<Lit>& out)
+{
+    vec<char>&  seen = analyze_seen;
+    out.clear();
+    for (; *a != lit_Undef; a++){
+        seen[var(*a)] = 1 + sign(*a);
+        out.push(*a); }
+    int         n_a  = out.size();
+
+    bool        taut = false;
+    for (; *b != lit_Undef && !taut; b++){
+        if (seen[var(*b)] == 0)
+            out.push(*b);
+        else if (seen[var(*b)] != 1 + sign(*b))
+            taut = true;
+    }
+
+    for (int i = 0; i < n_a; i++)
+        seen[var(out[i])] = 0;
+    return !taut;
+}
+
+
+// Remove every problem clause containing 'p' (during 'eliminate()'), both halves of the binary ones.
+//
+void Solver::removeClauses(Lit p)
+{
+    assert(proof == NULL);
+    vec<Lit>&  bs = bin_watches[index(~p)];
+    for (int i = 0; i < bs.size(); i++){
+        vec<Lit>& os = bin_watches[index(~bs[i])];
+        int       j  = 0;
+        for (; os[j] != p; j++) assert(j < os.size());
+        for (; j < os.size()-1; j++) os[j] = os[j+1];
+        os.pop();
+        touched[var(bs[i])] = 1;
+    }
+    n_bin_clauses          -= bs.size();
+    stats.clauses_literals -= 2 * bs.size();
+    bs.clear(true);
+
+    vec<CRef>& cs = occurs[index(p)];
+    for (int i = 0; i < cs.size(); i++){
+        const Clause& c = ca[cs[i]];
+        for (int k = 0; k < c.size(); k++){
+            touched[var(c[k])] = 1;
+            if (c[k] != p)
+                removeOcc(occurs[index(c[k])], cs[i]);
+        }
+        remove(cs[i]);
+    }
+    cs.clear(true);
+}
+
+
+// Give the eliminated variables values in 'model' that satisfy the clauses 'eliminate()' removed,
+// going through the variables in the reverse order of elimination.
+//
+void Solver::extendModel()
+{
+    for (int i = elim_clauses.size(); i > 0;){
+        int     size = elim_clauses[--i];
+        i -= size;
+        bool    sat  = false;
+        for (int k = 1; k < size && !sat; k++){
+            Lit q = toLit(elim_clauses[i + k]);
+            sat = (sign(q) ? ~model[var(q)] : model[var(q)]) != l_False;
+        }
+        if (!sat){
+            Lit x = toLit(elim_clauses[i]);
+            model[var(x)] = sign(x) ? l_False : l_True; }
+    }
+}
+
+
+// Keep the current (complete) assignment: all of it in 'model' with 'full_model', and the projected
+// variables in 'proj_model'. A projected variable that was eliminated needs the full copy (see
+// 'extendModel()').
+//
+void Solver::saveModel()
+{
+    bool    full = full_model;
+    for (int i = 0; i < projection.size() && !full; i++)
+        full = eliminated[projection[i]];
+
+    if (full){
+        model.growTo(nVars());
+        for (int i = 0; i < nVars(); i++) model[i] = value(i);
+        if (n_eliminated > 0) extendModel(); }
+
+    proj_model.growTo((projection.size() + 63) >> 6, 0);
+    for (int i = 0; i < projection.size(); i++){
+        Var x = projection[i];
+        if ((full ? model[x] : value(x)) == l_True)
+            proj_model[i >> 6] |= (uint64)1 << (i & 63); }
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  inprocess : [void]  ->  [bool]
+|  
+|  Description:
+|    Simplify the problem at the top level, between calls to 'solve()':
+|      * Literals in the same strongly connected component of the binary implication graph are
+|        equivalent. Each one is replaced by the representative of its class in all clauses
+|        (problem and learnt) and its variable is removed like an eliminated one (the model gets
+|        its value from the representative). Frozen variables are preferred as representatives
+|        and are never replaced. The SCCs are only looked for again when the binary clauses or
+|        the top-level assignment changed.
+|      * Failed literals: a literal whose propagation leads to a conflict is false at the top
+|        level. The roots of the binary implication graph are probed in turn, for 'probe_effort'
+|        times the propagations made since the last call.
+|      * XOR constraints are recovered from the clauses on the first call ('recoverXors()'), and
+|        Gauss-Jordan elimination derives units and equivalences from them whenever they changed
+|        ('gaussXors()'). The equivalences are substituted right away.
+|    No substitution is done when logging proofs (the rewritten clauses would have to be logged
+|    as chains); the failed literals are learnt through 'analyze()' and logged as usual.
+|  
+|  Output:
+|    FALSE if the problem was found unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::inprocess()
+{
+    if (!ok) return false;
+    assert(decisionLevel() == 0);
+
+    simplifyDB();
+    if (!xors_recovered) recoverXors();
+    if (ok && gauss_dirty && proof == NULL) gaussXors();
+    if (!ok) return false;
+
+    if (n_bin_clauses != inprocess_bins || nAssigns() != inprocess_assigns){
+        if (proof == NULL) substitute();
+        probe_sweep = 0; }
+    if (ok && probe_sweep < nVars())
+        probe(max((int64)10000, (int64)((stats.propagations - inprocess_props) * probe_effort)));
+
+    inprocess_bins    = n_bin_clauses;
+    inprocess_assigns = nAssigns();
+    inprocess_props   = stats.propagations;
+    return ok;
+}
+
+
+// Replace every literal by the representative of its equivalence class (see 'inprocess()').
+//
+void Solver::substitute()
+{
+    vec<Lit>    repr;
+    findEquivalences(repr);
+    if (!ok) return;
+
+    // Remove the replaced variables, 'x' taking the value of its representative 'r' in the model
+    // (clause 'x | ~r', default value false):
+    vec<Var>    replaced;
+    for (Var x = 0; x < nVars(); x++){
+        Lit r = repr[index(Lit(x))];
+        if (r != Lit(x)){
+            elim_clauses.push(index(Lit(x)));
+            elim_clauses.push(index(~r));
+            elim_clauses.push(2);
+            elim_clauses.push(index(~Lit(x)));
+            elim_clauses.push(1);
+            eliminated[x] = 1;
+            n_eliminated++;
+            stats.substituted++;
+            setDecisionVar(x, false);
+            replaced.push(x); }
+    }
+    if (replaced.size() == 0) return;
+
+    // Take out the binary clauses on replaced variables, rewritten as pairs of literals:
+    vec<Lit>    pairs;
+    for (int i = 0; i < replaced.size(); i++){
+        for (int s = 0; s < 2; s++){
+            Lit              p  = Lit(replaced[i], s);
+            const vec<Lit>&  bs = bin_watches[index(~p)];    // (the clauses 'p | bs[k]')
+            for (int k = 0; k < bs.size(); k++){
+                Lit q = bs[k];
+                if (repr[index(q)] == q){
+                    vec<Lit>& os = bin_watches[index(~q)];
+                    int       j  = 0;
+                    for (; os[j] != p; j++) assert(j < os.size());
+                    for (; j < os.size()-1; j++) os[j] = os[j+1];
+                    os.pop();
+                }else if (index(q) < index(p))
+                    continue;       // (taken from the side of 'q')
+                pairs.push(repr[index(p)]);
+                pairs.push(repr[index(q)]);
+            }
+        }
+    }
+    for (int i = 0; i < replaced.size(); i++){
+        bin_watches[index( Lit(replaced[i]))].clear(true);
+        bin_watches[index(~Lit(replaced[i]))].clear(true); }
+    n_bin_clauses          -= pairs.size() / 2;
+    stats.clauses_literals -= pairs.size();
+
+    // Take out the other clauses on replaced variables:
+    vec<CRef>   rewrite;
+    for (int type = 0; type < 2; type++){
+        vec<CRef>&    cs = type ? learnts : clauses;
+        int           j  = 0;
+        for (int i = 0; i < cs.size(); i++){
+            const Clause& c   = ca[cs[i]];
+            bool          hit = false;
+            for (int k = 0; k < c.size() && !hit; k++)
+                hit = repr[index(c[k])] != c[k];
+            if (hit)
+                rewrite.push(cs[i]);
+            else
+                cs[j++] = cs[i];
+        }
+        cs.shrink(cs.size()-j);
+    }
+
+    // Add them back in terms of the representatives:
+    vec<Lit>&   lits = substitute_lits;
+    for (int i = 0; i < rewrite.size() && ok; i++){
+        const Clause& c = ca[rewrite[i]];
+        lits.clear();
+        for (int k = 0; k < c.size(); k++)
+            lits.push(repr[index(c[k])]);
+        if (locked(rewrite[i]))
+            vardata[var(c[0])].reason = GClause_NULL;   // (a top-level fact; no proof is logged, so its reason is not needed)
+        remove(rewrite[i]);
+        addRewritten(lits, rewrite[i]);
+    }
+    for (int i = 0; i < pairs.size() && ok; i += 2){
+        lits.clear();
+        lits.push(pairs[i]);
+        lits.push(pairs[i+1]);
+        addRewritten(lits, CRef_Undef);
+    }
+
+    // And the XOR constraints:
+    int     n = 0;
+    rewrite.clear();
+    for (int i = 0; i < xors.size(); i++){
+        const Clause& c   = ca[xors[i]];
+        bool          hit = false;
+        for (int k = 0; k < c.size() && !hit; k++)
+            hit = repr[index(c[k])] != c[k];
+        if (hit)
+            rewrite.push(xors[i]);
+        else
+            xors[n++] = xors[i];
+    }
+    xors.shrink(xors.size() - n);
+    for (int i = 0; i < rewrite.size() && ok; i++){
+        const Clause& c = ca[rewrite[i]];
+        lits.clear();
+        for (int k = 0; k < c.size(); k++)
+            lits.push(repr[index(c[k])]);
+        if (locked(rewrite[i]))
+            vardata[var(c[0])].reason = GClause_NULL;
+        removeXor(rewrite[i]);
+        newXor(lits);
+    }
+
+    // Forget the gates that lost their output or an input:
+    for (Var x = 0; x < nVars(); x++)
+        if (gates[x].type != gate_None && (eliminated[x] || eliminated[var(gates[x].a)] || eliminated[var(gates[x].b)]))
+            gates[x] = Gate();
+
+    if (ok && propagate() != CRef_Undef)
+        ok = false;
+    checkGarbage();
+}
+
+
+// Map every literal to the representative of its equivalence class, or to itself. The classes are
+// the strongly connected components of the binary implication graph over the unassigned literals,
+// found by Tarjan's algorithm (without recursion, the implication chains can be long). Clears
+// 'ok' if a literal is equivalent to its negation.
+//
+void Solver::findEquivalences(vec<Lit>& repr)
+{
+    int         n_lits   = 2*nVars();
+    vec<int>    num     (n_lits, -1);   // Visiting order (-1 = not visited yet).
+    vec<int>    low     (n_lits, 0);    // Smallest 'num' reachable through the component's literals.
+    vec<char>   on_stack(n_lits, 0);
+    vec<Lit>    stack;                  // Visited literals whose component is not finished.
+    vec<Lit>    path;                   // Depth-first search path...
+    vec<int>    next;                   // ...and the next edge to follow from each literal on it.
+    int         counter  = 0;
+
+    repr.clear();
+    for (int i = 0; i < n_lits; i++)
+        repr.push(toLit(i));
+
+    for (int i = 0; i < n_lits && ok; i++){
+        if (num[i] >= 0 || value(toLit(i)) != l_Undef || eliminated[var(toLit(i))])
+            continue;
+        num[i] = low[i] = counter++;
+        stack.push(toLit(i)); on_stack[i] = 1;
+        path .push(toLit(i)); next.push(0);
+
+        while (path.size() > 0 && ok){
+            Lit             p  = path.last();
+            const vec<Lit>& bs = bin_watches[index(p)];
+            if (next.last() < bs.size()){
+                Lit q = bs[next.last()++];
+                if (value(q) != l_Undef)
+                    continue;
+                if (num[index(q)] < 0){
+                    num[index(q)] = low[index(q)] = counter++;
+                    stack.push(q); on_stack[index(q)] = 1;
+                    path .push(q); next.push(0);
+                }else if (on_stack[index(q)])
+                    low[index(p)] = min(low[index(p)], num[index(q)]);
+                continue;
+            }
+
+            path.pop(); next.pop();
+            if (path.size() > 0)
+                low[index(path.last())] = min(low[index(path.last())], low[index(p)]);
+            if (low[index(p)] != num[index(p)])
+                continue;
+
+            // 'p' is the root of a component, which is on the stack from 'p' up:
+            int     start = stack.size() - 1;
+            while (stack[start] != p) start--;
+            if (start < stack.size() - 1){
+                // The component of the negations has the same representative (negated):
+                bool    done = false;
+                Lit     r    = lit_Undef;
+                for (int k = start; k < stack.size(); k++){
+                    Lit m = stack[k];
+                    if (repr[index(m)] != m)
+                        done = true;
+                    if (on_stack[index(~m)] && num[index(~m)] >= num[index(p)])
+                        ok = false;
+                    if (r == lit_Undef || (frozen[var(m)] && !frozen[var(r)]) || (frozen[var(m)] == frozen[var(r)] && var(m) < var(r)))
+                        r = m;
+                }
+                for (int k = start; k < stack.size() && ok && !done; k++){
+                    Lit m = stack[k];
+                    if (m != r && !frozen[var(m)])
+                        repr[index(m)] = r, repr[index(~m)] = ~r;
+                }
+            }
+            for (int k = start; k < stack.size(); k++)
+                on_stack[index(stack[k])] = 0;
+            stack.shrink(stack.size() - start);
+        }
+    }
+}
+
+
+// Add a clause rewritten by 'substitute()' in place of 'from' (removed, but not yet collected), or
+// of a binary clause if 'from' is 'CRef_Undef'. Learnt clauses stay learnt, with the same activity
+// and tier.
+//
+void Solver::addRewritten(vec<Lit>& ps, CRef from)
+{
+    if (from == CRef_Undef || !ca[from].learnt()){
+        addClause(ps);
+        return; }
+
+    float   act  = ca[from].activity();
+    int     lbd  = ca[from].lbd();
+    int     tier = ca[from].tier();
+    int     used = ca[from].used();
+
+    sortUnique(ps);
+    for (int i = 0; i < ps.size()-1; i++)
+        if (ps[i] == ~ps[i+1])
+            return;
+    int     i, j;
+    for (i = j = 0; i < ps.size(); i++){
+        if (value(ps[i]) == l_True)
+            return;
+        else if (value(ps[i]) == l_Undef)
+            ps[j++] = ps[i];
+    }
+    ps.shrink(i - j);
+    if (ps.size() <= 2){
+        addClause(ps);      // (units and binary clauses are not told apart from the problem clauses)
+        return; }
+
+    CRef    cr = ca.alloc(true, ps);
+    Clause& c  = ca[cr];
+    c.activity() = act;
+    c.setLbd(lbd);
+    c.setTier(tier);
+    c.setUsed(used);
+    learnts_tier[tier]++;
+    watches[index(~c[0])].push(Watcher(cr, c[1]));
+    watches[index(~c[1])].push(Watcher(cr, c[0]));
+    learnts.push(cr);
+    stats.learnts_literals += c.size();
+}
+
+
+// Probe the roots of the binary implication graph (literals implying others, implied by none) for
+// failed literals, from where the last call stopped, until 'budget' propagations are spent or no
+// variable is left to try (see 'inprocess()').
+//
+void Solver::probe(int64 budget)
+{
+    vec<Lit>&   saved = probe_saved;
+    int64       stop  = stats.propagations + budget;
+    root_level = 0;
+    while (probe_sweep < nVars() && stats.propagations < stop && ok){
+        Var     x = probe_next;
+        probe_next = (probe_next + 1) % nVars();
+        probe_sweep++;
+        for (int s = 0; s < 2 && ok; s++){
+            Lit p = Lit(x, s);
+            if (value(p) != l_Undef || eliminated[x] || bin_watches[index(~p)].size() > 0 || bin_watches[index(p)].size() == 0)
+                continue;
+
+            check(assume(p));
+            CRef        confl = propagate();
+            vec<Lit>    learnt_clause;
+            int         backtrack_level, lbd;
+            if (confl != CRef_Undef)
+                analyze(confl, learnt_clause, backtrack_level, lbd);
+
+            // Backtrack, keeping the phases saved by the search:
+            saved.clear();
+            for (int i = trail_lim[0]; i < trail.size(); i++)
+                saved.push(Lit(var(trail[i]), polarity[var(trail[i])]));
+            cancelUntil(0);
+            for (int i = 0; i < saved.size(); i++)
+                polarity[var(saved[i])] = sign(saved[i]);
+
+            if (confl == CRef_Undef)
+                continue;
+            assert(learnt_clause.size() == 1);  // (everything but the top level is at level 1)
+            newClause(learnt_clause, true, (proof != NULL) ? proof->last() : ClauseId_NULL, true, lbd);
+            stats.failed_literals++;
+            probe_sweep = 0;
+            if (ok && propagate() != CRef_Undef)
+                ok = false;
+        }
+    }
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  vivify : (seconds : double)  ->  [bool]
+|  
+|  Description:
+|    Shorten the learnt clauses of the core and mid tiers, lowest LBD first. The clause is left out
+|    and the negations of its literals are propagated one at a time: once that gives a conflict or
+|    makes a literal of the clause true, the literals assigned so far (and the true one) form a
+|    shorter clause; literals made false are dropped on the way. Each clause is tried once, until
+|    'seconds' (wall-clock) have passed.
+|  
+|    Call at the top level, between 'solve()' calls. Does nothing when logging proofs (the shorter
+|    clauses would need resolution chains).
+|  
+|  Output:
+|    FALSE if the problem was found unsatisfiable.
+|________________________________________________________________________________________________@*/
+struct vivify_lt {
+    ClauseAllocator& ca;
+    vivify_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) {
+        return ca[x].lbd() < ca[y].lbd() || (ca[x].lbd() == ca[y].lbd() && ca[x].activity() > ca[y].activity()); } };
+struct VivifyLit_lt {
+    const vec<double>& activity;
+    VivifyLit_lt(const vec<double>& a) : activity(a) {}
+    bool operator () (Lit p, Lit q) { return activity[var(p)] > activity[var(q)]; } };
+bool Solver::vivify(double seconds)
+{
+    if (!ok || proof != NULL) return ok;
+    assert(decisionLevel() == 0);
+
+    simplifyDB();
+    if (!ok) return false;
+
+    vec<CRef>   cands;
+    for (int i = 0; i < learnts.size(); i++){
+        const Clause& c = ca[learnts[i]];
+        if (c.tier() != tier_Local && !c.vivified())
+            cands.push(learnts[i]);
+    }
+    sort(cands, vivify_lt(ca));
+
+    vec<Lit>&   lits  = vivify_lits;
+    vec<Lit>&   order = vivify_order;
+    vec<Lit>&   saved = probe_saved;
+    vec<CRef>   gone;
+    double      stop  = realTime() + seconds;
+    root_level = 0;
+    for (int i = 0; i < cands.size() && ok && realTime() < stop; i++){
+        CRef    cr = cands[i];
+        Clause& c  = ca[cr];
+        c.setVivified();
+        if (simplify(cr)) continue;
+
+        removeWatch(watches[index(~c[0])], cr);
+        removeWatch(watches[index(~c[1])], cr);
+        order.clear();
+        for (int k = 0; k < c.size(); k++)
+            order.push(c[k]);
+        sort(order, VivifyLit_lt(activity));     // (the most active variables first, for an early conflict)
+        lits.clear();
+        for (int k = 0; k < order.size(); k++){
+            Lit p = order[k];
+            if (value(p) == l_False) continue;          // (implied false by the others)
+            lits.push(p);
+            if (value(p) == l_True) break;              // (implied true by the others)
+            check(assume(~p));
+            if (propagate() != CRef_Undef) break;       // (the others are contradictory)
+        }
+
+        // Backtrack, keeping the phases saved by the search:
+        if (decisionLevel() > 0){
+            saved.clear();
+            for (int k = trail_lim[0]; k < trail.size(); k++)
+                saved.push(Lit(var(trail[k]), polarity[var(trail[k])]));
+            cancelUntil(0);
+            for (int k = 0; k < saved.size(); k++)
+                polarity[var(saved[k])] = sign(saved[k]); }
+
+        if (lits.size() == c.size()){
+            watches[index(~c[0])].push(Watcher(cr, c[1]));
+            watches[index(~c[1])].push(Watcher(cr, c[0]));
+            continue; }
+
+        stats.vivified++;
+        stats.vivified_literals += c.size() - lits.size();
+        stats.learnts_literals  -= c.size();
+        learnts_tier[c.tier()]--;
+        remove(cr, true);
+        gone.push(cr);
+        int n = learnts.size();
+        addRewritten(lits, cr);
+        if (learnts.size() > n)
+            ca[learnts.last()].setVivified();
+        if (ok && propagate() != CRef_Undef)
+            ok = false;
+    }
+
+    if (gone.size() > 0){
+        sort(gone);
+        int     j = 0;
+        for (int i = 0; i < learnts.size(); i++){
+            int lo = 0, hi = gone.size();
+            while (lo < hi){
+                int mid = (lo + hi) / 2;
+                if (gone[mid] < learnts[i]) lo = mid + 1; else hi = mid; }
+            if (lo == gone.size() || gone[lo] != learnts[i])
+                learnts[j++] = learnts[i];
+        }
+        learnts.shrink(learnts.size() - j);
+        checkGarbage();
+    }
+    return ok;
+}
+
+// XOR constraints are recognized among the problem clauses of 3 to 5 literals: the clauses over the
+// same variables with sign patterns of equal parity, all of them, exclude exactly the assignments
+// with the other parity. They are replaced by the constraint (see 'addXor()').
+//
+struct XorCand {
+    Var     v[5];       // (sorted)
+    int     size;
+    int     mask;       // (bit 'k' set if 'v[k]' occurs negated)
+    CRef    cr;
+};
+
+struct XorCand_lt {
+    bool operator () (const XorCand& x, const XorCand& y) {
+        if (x.size != y.size) return x.size < y.size;
+        for (int k = 0; k < x.size; k++)
+            if (x.v[k] != y.v[k]) return x.v[k] < y.v[k];
+        return x.mask < y.mask; }
+};
+
+static inline bool sameVars(const XorCand& x, const XorCand& y) {
+    if (x.size != y.size) return false;
+    for (int k = 0; k < x.size; k++)
+        if (x.v[k] != y.v[k]) return false;
+    return true; }
+
+static inline int parity(int mask) { int p = 0; for (; mask != 0; mask &= mask - 1) p ^= 1; return p; }
+
+void Solver::recoverXors()
+{
+    xors_recovered = true;
+    if (!ok || !native_xor || proof != NULL) return;
+    assert(decisionLevel() == 0);
+
+    vec<XorCand>    cands;
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.size() < 3 || c.size() > 5) continue;
+        XorCand x;
+        Lit     ls[5];
+        bool    assigned = false;
+        for (int k = 0; k < c.size(); k++)
+            ls[k] = c[k], assigned |= value(c[k]) != l_Undef;
+        if (assigned) continue;
+        sort(ls, c.size());
+        x.size = c.size();
+        x.mask = 0;
+        x.cr   = clauses[i];
+        for (int k = 0; k < x.size; k++){
+            x.v[k]  = var(ls[k]);
+            x.mask |= sign(ls[k]) << k; }
+        cands.push(x);
+    }
+    sort(cands, XorCand_lt());
+
+    // Groups of clauses on the same variables:
+    vec<CRef>   gone;
+    vec<Lit>    lits;
+    for (int i = 0, j; i < cands.size(); i = j){
+        for (j = i + 1; j < cands.size() && sameVars(cands[i], cands[j]); j++);
+        int     need     = 1 << (cands[i].size - 1);
+        int     count[2] = { 0, 0 };
+        for (int k = i; k < j; k++)
+            if (k == i || cands[k].mask != cands[k-1].mask)
+                count[parity(cands[k].mask)]++;
+        for (int p = 0; p < 2; p++){
+            if (count[p] != need) continue;
+            // The clauses with sign parity 'p' exclude the assignments of parity 'p':
+            for (int k = i; k < j; k++)
+                if (parity(cands[k].mask) == p)
+                    gone.push(cands[k].cr);
+            lits.clear();
+            for (int k = 0; k < cands[i].size; k++)
+                lits.push(Lit(cands[i].v[k]));
+            if (p == 1)
+                lits[0] = ~lits[0];     // (the XOR of the variables is '!p')
+            newXor(lits);
+            break;
+        }
+    }
+    if (gone.size() == 0) return;
+
+    sort(gone);
+    int     j = 0;
+    for (int i = 0; i < clauses.size(); i++){
+        int lo = 0, hi = gone.size();
+        while (lo < hi){
+            int mid = (lo + hi) / 2;
+            if (gone[mid] < clauses[i]) lo = mid + 1; else hi = mid; }
+        if (lo < gone.size() && gone[lo] == clauses[i])
+            remove(clauses[i]);
+        else
+            clauses[j++] = clauses[i];
+    }
+    clauses.shrink(clauses.size() - j);
+    checkGarbage();
+}
+
+
+// Gauss-Jordan elimination on the XOR constraints, one cluster (constraints connected by shared
+// variables) at a time, at the top level. The rows of at most two variables in the reduced form are
+// added as units and equivalences (clauses); an empty row with an odd right-hand side is a conflict.
+//
+static bool hasLit(const vec<Lit>& ps, Lit p)
+{
+    for (int i = 0; i < ps.size(); i++)
+        if (ps[i] == p) return true;
+    return false;
+}
+
+static Var gaussFind(vec<Var>& parent, Var x)
+{
+    while (parent[x] != x)
+        x = parent[x] = parent[parent[x]];
+    return x;
+}
+
+void Solver::gaussXors()
+{
+    gauss_dirty = false;
+    if (!ok || proof != NULL || xors.size() == 0) return;
+    assert(decisionLevel() == 0);
+
+    vec<Var>    parent(nVars());
+    for (Var x = 0; x < nVars(); x++)
+        parent[x] = x;
+    for (int i = 0; i < xors.size(); i++){
+        const Clause& c = ca[xors[i]];
+        for (int k = 1; k < c.size(); k++){
+            Var a = gaussFind(parent, var(c[0])), b = gaussFind(parent, var(c[k]));
+            if (a != b) parent[a] = b; }
+    }
+    vec<uint64> order;          // (cluster of each constraint in the upper half, index in the lower)
+    for (int i = 0; i < xors.size(); i++)
+        order.push((uint64)gaussFind(parent, var(ca[xors[i]][0])) << 32 | i);
+    sort(order);
+
+    vec<int>    column(nVars(), -1);
+    vec<Var>    vars;
+    vec<uint64> m;
+    vec<char>   rhs;
+    vec<Lit>    lits;
+    for (int i = 0, j; i < order.size() && ok; i = j){
+        for (j = i + 1; j < order.size() && (order[j] >> 32) == (order[i] >> 32); j++);
+        int rows = j - i;
+        if (rows < 2 || rows > gauss_max_rows) continue;
+
+        // Build the matrix (variables assigned at the top level go to the right-hand side):
+        vars.clear();
+        for (int r = i; r < j; r++){
+            const Clause& c = ca[xors[(int)(order[r] & 0xffffffff)]];
+            for (int k = 0; k < c.size(); k++)
+                if (value(c[k]) == l_Undef && column[var(c[k])] == -1){
+                    column[var(c[k])] = vars.size();
+                    vars.push(var(c[k])); }
+        }
+        int words = (vars.size() + 63) / 64;
+        m.clear(); m.growTo(rows * words, 0);
+        rhs.clear(); rhs.growTo(rows, 1);
+        for (int r = 0; r < rows; r++){
+            const Clause& c = ca[xors[(int)(order[i + r] & 0xffffffff)]];
+            for (int k = 0; k < c.size(); k++){
+                rhs[r] ^= sign(c[k]);
+                if (value(c[k]) != l_Undef)
+                    rhs[r] ^= (value(var(c[k])) == l_True);
+                else{
+                    int col = column[var(c[k])];
+                    m[r * words + col / 64] ^= (uint64)1 << (col % 64); }
+            }
+        }
+
+        // Reduce:
+        int rank = 0;
+        for (int col = 0; col < vars.size() && rank < rows; col++){
+            int     w   = col / 64;
+            uint64  bit = (uint64)1 << (col % 64);
+            int     piv = rank;
+            while (piv < rows && (m[piv * words + w] & bit) == 0) piv++;
+            if (piv == rows) continue;
+            if (piv != rank){
+                for (int k = 0; k < words; k++){
+                    uint64 tmp = m[piv * words + k]; m[piv * words + k] = m[rank * words + k]; m[rank * words + k] = tmp; }
+                char tmp = rhs[piv]; rhs[piv] = rhs[rank]; rhs[rank] = tmp; }
+            for (int r = 0; r < rows; r++)
+                if (r != rank && (m[r * words + w] & bit) != 0){
+                    for (int k = w; k < words; k++)     // (the columns before 'col' are zero in the pivot row)
+                        m[r * words + k] ^= m[rank * words + k];
+                    rhs[r] ^= rhs[rank]; }
+            rank++;
+        }
+
+        // Collect the short rows:
+        for (int r = 0; r < rows && ok; r++){
+            lits.clear();
+            for (int k = 0; k < words && lits.size() <= 2; k++)
+                for (uint64 b = m[r * words + k]; b != 0 && lits.size() <= 2; b &= b - 1){
+                    int col = k * 64;
+                    for (uint64 t = b & (~b + 1); t != 1; t >>= 1) col++;
+                    lits.push(Lit(vars[col])); }
+            if (lits.size() == 0){
+                if (rhs[r]) ok = false;
+            }else if (lits.size() <= 2){
+                if (!rhs[r]) lits[0] = ~lits[0];
+                if (lits.size() == 2 && hasLit(bin_watches[index(~lits[0])], lits[1]) && hasLit(bin_watches[index(lits[0])], ~lits[1]))
+                    continue;       // (a known equivalence)
+                newXor(lits);
+                stats.gauss_facts++; }
+        }
+
+        for (int k = 0; k < vars.size(); k++)
+            column[vars[k]] = -1;
+    }
+
+    if (ok && propagate() != CRef_Undef)
+        ok = false;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  search : (nof_conflicts : int) (nof_learnts : int) (params : const SearchParams&)  ->  [lbool]
@@ -655,61 +2394,276 @@ lbool Solver::search(int nof_conflicts, int nof_learnts, const SearchParams& par
     var_decay = 1 / params.var_decay;
     cla_decay = 1 / params.clause_decay;
     model.clear();
+    proj_model.clear();
 
     for (;;){
-        Clause* confl = propagate();
-        if (confl != NULL){
+        CRef confl = propagate();
+        if (confl != CRef_Undef){
             // CONFLICT
 
             stats.conflicts++; conflictC++;
+            if (chrono_lim > 0 && !backtrackToConflict(confl))
+                continue;
+
             vec<Lit>    learnt_clause;
             int         backtrack_level;
+            int         lbd;
             if (decisionLevel() == root_level){
                 // Contradiction found:
                 analyzeFinal(confl);
                 return l_False; }
-            analyze(confl, learnt_clause, backtrack_level);
-            cancelUntil(max(backtrack_level, root_level));
-            newClause(learnt_clause, true, (proof != NULL) ? proof->last() : ClauseId_NULL);
-            if (learnt_clause.size() == 1) level[var(learnt_clause[0])] = 0;    // (this is ugly (but needed for 'analyzeFinal()') -- in future versions, we will backtrack past the 'root_level' and redo the assumptions)
+
+            if (params.restart == restart_Glucose){
+                // Block the restart if the assignment is much larger than usual (we may be close to a model):
+                if (params.restart_blocking && stats.conflicts > 10000 && lbd_queue.full() && trail.size() > params.restart_R * trail_queue.avg())
+                    lbd_queue.clear(), stats.blocked_restarts++;
+                trail_queue.push(trail.size());
+            }
+
+            analyze(confl, learnt_clause, backtrack_level, lbd);
+            lbd_queue.push(lbd);
+            stats.tot_lbd += lbd;
+            int target = max(backtrack_level, root_level);
+            if (chrono_lim > 0 && decisionLevel() - target > chrono_lim)
+                // Too long a jump: keep the levels in between, the learnt clause asserts below the current level
+                target = decisionLevel() - 1, stats.chrono_backtracks++;
+            cancelUntil(target);
+            newClause(learnt_clause, true, (proof != NULL) ? proof->last() : ClauseId_NULL, true, lbd);
+            order.flush();
             varDecayActivity();
             claDecayActivity();
 
+            if (params.rephase_first > 0 && stats.conflicts >= next_rephase)
+                rephase(params);
+
         }else{
             // NO CONFLICT
 
-            if (nof_conflicts >= 0 && conflictC >= nof_conflicts){
-                // Reached bound on number of conflicts:
+            if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || !withinLimits()
+            ||  (params.restart == restart_Glucose && lbd_queue.full() && lbd_queue.avg() * params.restart_K > (double)stats.tot_lbd / stats.conflicts)){
+                // Reached bound on number of conflicts (or the budget of this 'solve()' call):
                 progress_estimate = progressEstimate();
+                lbd_queue.clear();
                 cancelUntil(root_level);
                 return l_Undef; }
 
-            if (decisionLevel() == 0)
-                // Simplify the set of problem clauses:
-                simplifyDB(), assert(ok);
+            if (decisionLevel() == 0){
+                // Simplify the set of problem clauses (which may find new facts, and a conflict):
+                simplifyDB();
+                if (!ok) return l_False; }
 
-            if (nof_learnts >= 0 && learnts.size()-nAssigns() >= nof_learnts)
-                // Reduce the set of learnt clauses:
+            if (nof_learnts >= 0 && learnts_tier[tier_Local]-nAssigns() >= nof_learnts)
+                // Reduce the set of learnt clauses (only the local tier counts):
                 reduceDB();
 
+            if (params.phase == phase_Target && trail.size() > target_size)
+                // Largest conflict-free assignment so far:
+                saveTarget();
+
             // New variable decision:
             stats.decisions++;
-            Var next = order.select(params.random_var_freq);
+            Lit next = pickBranchLit(params);
 
-            if (next == var_Undef){
+            if (next == lit_Undef){
                 // Model found:
-                model.growTo(nVars());
-                for (int i = 0; i < nVars(); i++) model[i] = value(i);
+                saveModel();
                 cancelUntil(root_level);
                 return l_True;
             }
 
-            check(assume(~Lit(next)));
+            check(assume(next));
         }
     }
 }
 
 
+// With chronological backtracking, the conflict clause 'confl' may be of lower levels than the
+// current one: backtrack to its highest level. If that level has just one literal of the clause,
+// the clause asserts it at the level below, which is done here instead of a conflict analysis
+// (FALSE is returned). TRUE means 'confl' is to be analyzed at the current level.
+//
+bool Solver::backtrackToConflict(CRef confl)
+{
+    Clause& c     = ca[confl];
+    int     top   = 0;
+    int     i_top = 0;
+    int     n_top = 0;
+    for (int i = 0; i < c.size(); i++){
+        int l = vardata[var(c[i])].level;
+        if (l > top)
+            top = l, i_top = i, n_top = 1;
+        else if (l == top)
+            n_top++;
+    }
+    if (top <= root_level || n_top > 1 || c.isXor()){
+        if (top == 0)
+            ok = false;     // (a conflict of top-level facts)
+        cancelUntil(max(top, root_level));
+        return true; }
+
+    Lit q = c[i_top];
+    cancelUntil(top - 1);
+    if (confl == propagate_tmpbin)
+        check(enqueue(q, GClause_new(c[1 - i_top]), vardata[var(c[1 - i_top])].level));
+    else{
+        // Watch 'q' and the false literal of the highest level, with 'q' first as in any reason:
+        removeWatch(watches[index(~c[0])], confl);
+        removeWatch(watches[index(~c[1])], confl);
+        c[i_top] = c[0]; c[0] = q;
+        int max_k = 1;
+        for (int k = 2; k < c.size(); k++)
+            if (vardata[var(c[k])].level > vardata[var(c[max_k])].level)
+                max_k = k;
+        Lit tmp = c[1]; c[1] = c[max_k]; c[max_k] = tmp;
+        watches[index(~c[0])].push(Watcher(confl, c[1]));
+        watches[index(~c[1])].push(Watcher(confl, c[0]));
+        check(enqueue(q, GClause_new(confl), vardata[var(c[1])].level));
+    }
+    return false;
+}
+
+
+// Pick an unassigned decision variable by activity and a polarity for it according to
+// 'params.phase'. Returns 'lit_Undef' if all variables are assigned. Non-decision variables left
+// unassigned after all decision variables are not determined by them; they are branched on in
+// index order (counted in 'stats.fallback_decisions', they stay non-decision variables), so that a
+// model is always complete (up to the eliminated variables, see 'extendModel()'). Frozen ones are
+// set false: they are meant for the assumptions (e.g. the activation literals of 'SatSolver'
+// groups, whose clauses false satisfies), not for the search. With
+// 'params.justify', the inputs of unjustified gates are branched on first (decision variables or not).
+//
+Lit Solver::pickBranchLit(const SearchParams& params)
+{
+    if (params.justify){
+        Lit p = pickJustifyLit(params);
+        if (p != lit_Undef){
+            stats.justify_decisions++;
+            return p; }
+    }
+
+    Var next = order.select(params.random_var_freq);
+    if (next == var_Undef){
+        if (trail.size() + n_eliminated == nVars())
+            return lit_Undef;
+        while (value(fallback_next) != l_Undef || eliminated[fallback_next])
+            fallback_next++;
+        stats.fallback_decisions++;
+        if (frozen[fallback_next])
+            return ~Lit(fallback_next);
+        next = fallback_next;
+    }
+
+    return phaseLit(next, params);
+}
+
+
+// The literal of 'x' to branch on according to 'params.phase'.
+//
+Lit Solver::phaseLit(Var x, const SearchParams& params)
+{
+    switch (params.phase){
+    case phase_False:  return ~Lit(x);
+    case phase_Target: return Lit(x, target_polarity[x]);
+    default:           return Lit(x, polarity[x]);
+    }
+}
+
+
+// Is the value of the (assigned) gate output 'x' explained by its inputs? Only an AND gate that is
+// false and a XOR gate can be unjustified; in all other cases propagation assigns the inputs.
+//
+bool Solver::justified(Var x)
+{
+    const Gate& g = gates[x];
+    if (g.type == gate_And)
+        return value(x) == l_True || value(g.a) == l_False || value(g.b) == l_False;
+    else
+        return value(g.a) != l_Undef || value(g.b) != l_Undef;
+}
+
+
+// Justification frontier: the most recently assigned unjustified gate output is justified by
+// branching on its more active input (to the controlling value for an AND gate). Gates assigned
+// since the last call are scanned from the trail; a gate that loses its justification when the
+// solver backtracks past the input but not the output is only found again if reassigned, which
+// just leaves the decision to 'order'. Returns 'lit_Undef' if the frontier is empty.
+//
+Lit Solver::pickJustifyLit(const SearchParams& params)
+{
+    for (; justify_head < trail.size(); justify_head++){
+        Var x = var(trail[justify_head]);
+        if (gates[x].type != gate_None && !justified(x))
+            justify_frontier.push(x);
+    }
+
+    while (justify_frontier.size() > 0){
+        Var x = justify_frontier.last();
+        if (value(x) == l_Undef || justified(x)){
+            justify_frontier.pop();
+            continue; }
+
+        const Gate& g = gates[x];
+        Lit p = (activity[var(g.a)] >= activity[var(g.b)]) ? g.a : g.b;
+        return (g.type == gate_And) ? ~p : phaseLit(var(p), params);
+    }
+    return lit_Undef;
+}
+
+
+// Copy the phases of the current (conflict-free) assignment to 'target_polarity'. Only the part of
+// the trail that changed since the last call is copied.
+//
+void Solver::saveTarget()
+{
+    for (int i = target_saved; i < trail.size(); i++)
+        target_polarity[var(trail[i])] = sign(trail[i]);
+    target_saved = target_size = trail.size();
+}
+
+
+// Reset the saved phases, cycling through: the initial phases, the target phases, the inverted
+// initial phases and the target phases again. The interval between calls grows arithmetically.
+//
+void Solver::rephase(const SearchParams& params)
+{
+    switch (rephase_count++ % 4){
+    case 0:  for (int i = 0; i < nVars(); i++) polarity[i] = seed_polarity[i];  break;
+    case 2:  for (int i = 0; i < nVars(); i++) polarity[i] = !seed_polarity[i]; break;
+    default: for (int i = 0; i < nVars(); i++) polarity[i] = target_polarity[i]; break;
+    }
+    for (int i = 0; i < nVars(); i++) target_polarity[i] = polarity[i];
+    target_size  = target_saved = 0;
+    stats.rephases++;
+    next_rephase = stats.conflicts + (int64)params.rephase_first * (rephase_count + 1);
+}
+
+
+// Finite subsequences of the Luby-sequence:
+//
+//   0: 1
+//   1: 1 1 2
+//   2: 1 1 2 1 1 2 4
+//   3: 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8
+//   ...
+//
+// Returns the 'x':th element of the sequence with base 'y' (2 for the sequence above).
+//
+static double luby(double y, int x)
+{
+    // Find the finite subsequence that contains index 'x', and the size of that subsequence:
+    int size, seq;
+    for (size = 1, seq = 0; size < x+1; seq++, size = 2*size+1);
+
+    while (size-1 != x){
+        size = (size-1)>>1;
+        seq--;
+        x = x % size;
+    }
+
+    return pow(y, seq);
+}
+
+
 // Return search-space coverage. Not extremely reliable.
 //
 double Solver::progressEstimate()
@@ -718,11 +2672,26 @@ double Solver::progressEstimate()
     double  F = 1.0 / nVars();
     for (int i = 0; i < nVars(); i++)
         if (value(i) != l_Undef)
-            progress += pow(F, level[i]);
+            progress += pow(F, vardata[i].level);
     return progress / nVars();
 }
 
 
+// Returns FALSE once the conflict, propagation or time budget given to 'solve()' is used up.
+// The clock is only sampled every 64 calls.
+//
+bool Solver::withinLimits()
+{
+    if (!limit_reached){
+        if ((conflict_lim    >= 0 && stats.conflicts    >= conflict_lim)
+        ||  (propagation_lim >= 0 && stats.propagations >= propagation_lim)
+        ||  (time_lim        >= 0 && (time_check++ & 63) == 0 && realTime() >= time_lim))
+            limit_reached = true;
+    }
+    return !limit_reached;
+}
+
+
 // Divide all variable activities by 1e100.
 //
 void Solver::varRescaleActivity()
@@ -738,14 +2707,14 @@ void Solver::varRescaleActivity()
 void Solver::claRescaleActivity()
 {
     for (int i = 0; i < learnts.size(); i++)
-        learnts[i]->activity() *= 1e-20;
+        ca[learnts[i]].activity() *= 1e-20;
     cla_inc *= 1e-20;
 }
 
 
 /*_________________________________________________________________________________________________
 |
-|  solve : (assumps : const vec<Lit>&)  ->  [bool]
+|  solve : (assumps : const vec<Lit>&) (limits : const SolveLimits&)  ->  [lbool]
 |  
 |  Description:
 |    Top-level solve. If using assumptions (non-empty 'assumps' vector), you must call
@@ -755,25 +2724,53 @@ void Solver::claRescaleActivity()
 |  Input:
 |    A list of assumptions (unit clauses coded as literals). Pre-condition: The assumptions must
 |    not contain both 'x' and '~x' for any variable 'x'.
+|    Limits on conflicts, propagations and wall-clock time spent in this call.
+|  
+|  Output:
+|    'l_True' or 'l_False' if the problem is satisfiable or not under the assumptions. 'l_Undef' if
+|    the limits were reached first; neither 'model' nor 'conflict' is valid then.
 |________________________________________________________________________________________________@*/
-bool Solver::solve(const vec<Lit>& assumps)
+lbool Solver::solve(const vec<Lit>& assumps, const SolveLimits& limits)
 {
     simplifyDB();
-    if (!ok) return false;
+    if (!ok){
+        // Unsatisfiable whatever the assumptions: the conflict is empty (not the one of the last call)
+        conflict.clear();
+        if (proof != NULL) conflict_id = proof->last();
+        return l_False; }
+
+    conflict_lim    = (limits.conflicts    < 0) ? -1 : stats.conflicts    + limits.conflicts;
+    propagation_lim = (limits.propagations < 0) ? -1 : stats.propagations + limits.propagations;
+    time_lim        = (limits.seconds      < 0) ? -1 : realTime() + limits.seconds;
+    time_check      = 0;
+    limit_reached   = false;
 
     SearchParams    params(default_params);
-    double  nof_conflicts = 100;
-    double  nof_learnts   = nClauses() / 3;
+    double  nof_conflicts = params.restart_first;
+    double  nof_learnts   = nClauses() / 3;     // (binary clauses count too, learnt ones included, though the limit is on long local-tier learnts only)
     lbool   status        = l_Undef;
-
-    // Perform assumptions:
-    root_level = assumps.size();
+    int     curr_restarts = 0;
+    lbd_queue.clear();
+    trail_queue.clear();
+    order.setVmtf(params.var_order == order_VMTF);
+    justify_frontier.clear();
+    justify_head  = 0;
+    target_size   = 0;      // (the target phases are kept, but any assignment under the new assumptions may replace them)
+    if (params.rephase_first > 0 && next_rephase == 0) next_rephase = stats.conflicts + params.rephase_first;
+
+    // Perform assumptions (they share one decision level; those already true are skipped):
+    root_level = 0;
     for (int i = 0; i < assumps.size(); i++){
         Lit p = assumps[i];
         assert(var(p) < nVars());
-        if (!assume(p)){
-            if (reason[var(p)] != NULL){
-                analyzeFinal(reason[var(p)], true);
+        assert(!eliminated[var(p)]);    // (assumed variables must be frozen before 'eliminate()' and 'inprocess()')
+        if (value(p) == l_True)
+            continue;
+        if (root_level == 0)
+            trail_lim.push(trail.size()), root_level = 1;
+        if (!enqueue(p)){
+            if (vardata[var(p)].reason != GClause_NULL && vardata[var(p)].level > 0){     // (top-level facts have a 'unit_id'; their binary reasons may be gone)
+                analyzeFinal(reasonClause(var(p)), true);
                 conflict.push(~p);
             }else{
                 assert(proof == NULL || unit_id[var(p)] != ClauseId_NULL);   // (this is the pre-condition above)
@@ -782,14 +2779,15 @@ bool Solver::solve(const vec<Lit>& assumps)
                 if (proof != NULL) conflict_id = unit_id[var(p)];
             }
             cancelUntil(0);
-            return false; }
-        Clause* confl = propagate();
-        if (confl != NULL){
+            return l_False; }
+        CRef confl = propagate();
+        if (confl != CRef_Undef){
             analyzeFinal(confl), assert(conflict.size() > 0);
             cancelUntil(0);
-            return false; }
+            return l_False; }
     }
     assert(root_level == decisionLevel());
+    chrono_lim = (proof == NULL) ? params.chrono : 0;
 
     // Search:
     if (verbosity >= 1){
@@ -803,7 +2801,7 @@ bool Solver::solve(const vec<Lit>& assumps)
         reportf("===================================\n");
     }
 
-    while (status == l_Undef){
+    while (status == l_Undef && withinLimits()){
         if (verbosity >= 1){
             printStats();
             reportf("| %9d | %7d %8d | %7d %7d %8d %7.1f | %6.3f %% |\n",
@@ -815,18 +2813,31 @@ bool Solver::solve(const vec<Lit>& assumps)
                    progress_estimate*100);
             fflush(stdout);
         }
-        status = search((int)nof_conflicts, (int)nof_learnts, params);
+        int     restart_lim = (params.restart == restart_Geometric) ? (int)nof_conflicts
+                                : (params.restart == restart_Luby)      ? (int)(luby(2, curr_restarts) * params.restart_first)
+                                :                                         -1;   // (Glucose restarts are decided in 'search()')
+        status = search(restart_lim, (int)nof_learnts, params);
         nof_conflicts *= 1.5;
         nof_learnts   *= 1.1;
+        curr_restarts++;
 
     }
+    chrono_lim = 0;
     if (verbosity >= 1) {
         reportf("===========================================");
         reportf("===================================\n");
     }
 
     cancelUntil(0);
-    return status == l_True;
+    if (status == l_Undef){
+        model.clear();
+        proj_model.clear();
+        conflict.clear(); }
+    else if (status == l_False && !ok){
+        // A top-level conflict found in 'search()' (e.g. by 'simplifyDB()'): as above, the conflict is empty
+        conflict.clear();
+        if (proof != NULL) conflict_id = proof->last(); }
+    return status;
 }
 
 void Solver::printStats()
@@ -843,6 +2854,24 @@ void Solver::printStats()
            (int)stats.conflicts, nClauses(), (int)stats.clauses_literals,
            nLearnts(), (int)stats.learnts_literals,
            (double)stats.learnts_literals/nLearnts(), progress_estimate*100);
+    reportf("| Restarts %10lld | Blocked %10lld | Average LBD %8.2f    |\n",
+           stats.starts, stats.blocked_restarts, stats.conflicts == 0 ? 0 : (double)stats.tot_lbd/stats.conflicts);
+    reportf("| Decisions %10lld | Rephases %10lld | Justify %13lld |\n",
+           stats.decisions, stats.rephases, stats.justify_decisions);
+    reportf("| Fallback decisions %9lld |\n",
+           stats.fallback_decisions);
+    reportf("| Propagations %15lld | Chronological backtracks %10lld |\n",
+           stats.propagations, stats.chrono_backtracks);
+    reportf("| Literals removed %7.2f %%    | Reasons strengthened %12lld |\n",
+           stats.max_literals == 0 ? 0 : (stats.max_literals - stats.tot_literals) * 100 / (double)stats.max_literals, stats.otfs);
+    reportf("| Substituted %16lld | Failed literals %19lld |\n",
+           stats.substituted, stats.failed_literals);
+    reportf("| XOR constraints %12d | Gauss facts %23lld |\n",
+           nXors(), stats.gauss_facts);
+    reportf("| Subsumed %19lld | Strengthened %22lld |\n",
+           stats.subsumed, stats.strengthened);
+    reportf("| Vivified %19lld | Vivified literals %17lld |\n",
+           stats.vivified, stats.vivified_literals);
     reportf("=======================================");
     reportf("===============================\n");
 }
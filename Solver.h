@@ -35,14 +35,89 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 struct SolverStats {
     int64   starts, decisions, propagations, conflicts;
     int64   clauses_literals, learnts_literals, max_literals, tot_literals;
+    int64   blocked_restarts, tot_lbd, rephases, justify_decisions, fallback_decisions, otfs, chrono_backtracks;
+    int64   substituted, failed_literals, gauss_facts, subsumed, strengthened, vivified, vivified_literals;
     SolverStats() : starts(0), decisions(0), propagations(0), conflicts(0)
-      , clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0) { }
+      , clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+      , blocked_restarts(0), tot_lbd(0), rephases(0), justify_decisions(0), fallback_decisions(0), otfs(0), chrono_backtracks(0)
+      , substituted(0), failed_literals(0), gauss_facts(0), subsumed(0), strengthened(0), vivified(0), vivified_literals(0) { }
 };
 
 
+// Restart policies:
+const int restart_Geometric = 0;    // 'restart_first' conflicts, then 1.5 times more after each restart.
+const int restart_Luby      = 1;    // 'restart_first' times the Luby sequence (1 1 2 1 1 2 4 ...).
+const int restart_Glucose   = 2;    // Restart when the recent LBDs are high compared to the overall average.
+
+// Polarity of decisions:
+const int phase_False       = 0;    // Always branch on the negative literal.
+const int phase_Saved       = 1;    // Branch on the value the variable had last (phase saving).
+const int phase_Target      = 2;    // Branch on the value the variable had in the largest conflict-free assignment seen.
+
+// Decision variable order:
+const int order_VSIDS       = 0;    // Highest activity first (binary heap).
+const int order_VMTF        = 1;    // Most recently bumped first (move-to-front queue).
+
+// Gates known to the justification heuristic (output = a AND b, output = a XOR b):
+const int gate_None         = 0;
+const int gate_And          = 1;
+const int gate_Xor          = 2;
+
+struct Gate {
+    Lit     a, b;
+    int     type;
+    Gate() : type(gate_None) { }
+    Gate(int t, Lit a_, Lit b_) : a(a_), b(b_), type(t) { }
+};
+
 struct SearchParams {
     double  var_decay, clause_decay, random_var_freq;    // (reasonable values are: 0.95, 0.999, 0.02)    
-    SearchParams(double v = 1, double c = 1, double r = 0) : var_decay(v), clause_decay(c), random_var_freq(r) { }
+    int     restart;            // One of 'restart_Geometric', 'restart_Luby' or 'restart_Glucose'.
+    int     restart_first;      // Length of the first restart interval (Geometric, Luby).
+    double  restart_K;          // (Glucose) Restart when 'K' times the recent average LBD exceeds the overall average.
+    double  restart_R;          // (Glucose) Block the restart when the trail is 'R' times larger than it recently was...
+    bool    restart_blocking;   // ...if this is set.
+    int     phase;              // One of 'phase_False', 'phase_Saved' or 'phase_Target'.
+    int     rephase_first;      // Conflicts before the first rephasing, the interval grows by as much each time. 0 = never rephase.
+    int     var_order;          // Either 'order_VSIDS' or 'order_VMTF'.
+    bool    justify;            // Branch on the inputs of unjustified gates first (see 'Solver::addGate()').
+    int     chrono;             // Backtrack a single level when the learnt clause would undo more levels than this (chronological backtracking). 0 = never.
+    SearchParams(double v = 1, double c = 1, double r = 0) : var_decay(v), clause_decay(c), random_var_freq(r)
+      , restart(restart_Geometric), restart_first(100), restart_K(0.8), restart_R(1.4), restart_blocking(true)
+      , phase(phase_Saved), rephase_first(0), var_order(order_VSIDS), justify(false), chrono(0) { }
+};
+
+
+// The most recent 'size' values pushed and their average (for adaptive restarts):
+class BoundedQueue {
+    vec<int>    elems;
+    int         head, count;
+    int64       sum;
+public:
+    BoundedQueue(int size) : head(0), count(0), sum(0) { elems.growTo(size); }
+
+    void    push  (int x) {
+        if (count == elems.size()) sum -= elems[head]; else count++;
+        sum += x; elems[head] = x;
+        if (++head == elems.size()) head = 0; }
+    bool    full  () const { return count == elems.size(); }
+    double  avg   () const { return count == 0 ? 0 : (double)sum / count; }
+    void    clear ()       { head = count = 0; sum = 0; }
+};
+
+
+struct SolveLimits {
+    int64   conflicts, propagations;    // Budget for a single call to 'solve()'. Negative values mean no limit.
+    double  seconds;                    // Wall-clock budget in seconds. Negative value means no limit.
+    SolveLimits(int64 c = -1, int64 p = -1, double s = -1) : conflicts(c), propagations(p), seconds(s) { }
+};
+
+
+// The implication graph node of an assigned variable (the value itself is in 'Solver::assigns'):
+struct VarData {
+    GClause reason;     // The clause that implied the variable's current value, or 'GClause_NULL' if none. Binary clauses are stored as the other (false) literal.
+    int     level;      // The decision level at which the assignment was made.
+    VarData() : reason(GClause_NULL), level(-1) { }
 };
 
 
@@ -51,8 +126,11 @@ protected:
     // Solver state:
     //
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
-    vec<Clause*>        clauses;          // List of problem clauses.
-    vec<Clause*>        learnts;          // List of learnt clauses.
+    ClauseAllocator     ca;               // Region holding all clauses (problem, learnt and temporary).
+    vec<CRef>           clauses;          // List of problem clauses.
+    vec<CRef>           learnts;          // List of learnt clauses.
+    vec<CRef>           xors;             // List of XOR constraints (see 'addXor()').
+    int                 learnts_tier[3];  // Number of learnt clauses in each tier ('tier_Core', 'tier_Mid', 'tier_Local').
     vec<ClauseId>       unit_id;          // 'unit_id[var]' is the clause ID for the unit literal 'var' or '~var' (if set at toplevel).
     double              cla_inc;          // Amount to bump next clause with.
     double              cla_decay;        // INVERSE decay factor for clause activity: stores 1/decay.
@@ -62,28 +140,78 @@ protected:
     double              var_decay;        // INVERSE decay factor for variable activity: stores 1/decay. Use negative value for static variable order.
     VarOrder            order;            // Keeps track of the decision variable order.
 
-    vec<vec<Clause*> >  watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    vec<vec<Watcher> >  watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    vec<vec<Lit> >      bin_watches;      // 'bin_watches[lit]' holds the other literal of each binary clause containing '~lit' (implied if 'lit' becomes true).
+    vec<vec<ClauseId> > bin_ids;          // (In proof logging mode only.) Clause IDs of the binary clauses, parallel to 'bin_watches'.
+    int                 n_bin_clauses;    // Number of binary clauses (problem and learnt) stored implicitly in 'bin_watches'.
+    vec<vec<CRef> >     xor_watches;      // 'xor_watches[var]' lists the XOR constraints watching 'var' (the variables of their first two literals).
+    bool                xors_recovered;   // Set once 'recoverXors()' has run (clauses added later are not searched for XORs).
+    bool                gauss_dirty;      // The XOR constraints changed since the last 'gaussXors()'.
     vec<char>           assigns;          // The current assignments (lbool:s stored as char:s).
+    vec<char>           decision;         // Is the variable eligible for decisions?
+    vec<char>           polarity;         // The saved phase of each variable (1 = negative), used by 'phase_Saved'.
+    vec<char>           target_polarity;  // The phases of the largest conflict-free assignment seen since the last rephasing.
+    vec<char>           seed_polarity;    // The initial phases (negative unless given by 'seedPhase()').
+    int                 target_size;      // Size of the trail the target phases were taken from.
+    int                 target_saved;     // Prefix of the current trail already copied to 'target_polarity'.
+    int64               next_rephase;     // Value of 'stats.conflicts' at which to rephase next.
+    int                 rephase_count;    // Number of rephasings so far.
+    vec<Gate>           gates;            // 'gates[var]' is the gate driving the variable, if any (see 'addGate()').
+    vec<Var>            justify_frontier; // Gate outputs found unjustified (lazily validated: may hold stale entries).
+    int                 justify_head;     // Prefix of the current trail already scanned for unjustified gates.
+    int                 fallback_next;    // Variables below this one are assigned (or eliminated) once the decision variables are, see 'pickBranchLit()'.
+    vec<char>           frozen;           // Variables that 'eliminate()' and 'inprocess()' must keep (see 'setFrozen()').
+    vec<char>           eliminated;       // Variables removed by 'eliminate()' or substituted by 'inprocess()'. They occur in no clause and are never assigned.
+    int                 n_eliminated;     // Number of eliminated variables.
+    vec<int>            elim_clauses;     // Clauses removed with the eliminated variables (the eliminated literal first, then the others, then the size), for 'extendModel()'.
+    vec<Var>            projection;       // Variables whose values every model keeps in 'proj_model' (see 'setProjection()').
+    vec<uint64>         proj_model;       // Bit 'i' is the value of 'projection[i]' in the last model.
+    vec<vec<CRef> >     occurs;           // (During 'eliminate()' only.) 'occurs[lit]' lists the problem clauses (not binary) containing 'lit'.
+    vec<char>           touched;          // (During 'eliminate()' only.) Variables whose occurrences changed since they were last tried.
+    int                 inprocess_bins;   // Value of 'n_bin_clauses' when 'inprocess()' last looked for equivalent literals...
+    int                 inprocess_assigns;// ...and the number of top-level assignments (the SCCs change only with these).
+    int64               inprocess_props;  // Value of 'stats.propagations' at the end of the last 'inprocess()'.
+    Var                 probe_next;       // Variable the next round of failed-literal probing starts from.
+    int                 probe_sweep;      // Variables probed since a failed literal was found or the problem changed.
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail[]'.
-    vec<Clause*>        reason;           // 'reason[var]' is the clause that implied the variables current value, or 'NULL' if none.
-    vec<int>            level;            // 'level[var]' is the decision level at which assignment was made.
-    vec<int>            trail_pos;        // 'trail_pos[var]' is the variable's position in 'trail[]'. This supersedes 'level[]' in some sense, and 'level[]' will probably be removed in future releases.
-    int                 root_level;       // Level of first proper decision.
+    vec<VarData>        vardata;          // 'vardata[var]' is the reason and level of the variable's current assignment, read together by 'propagate()' and 'analyze()'.
+    int                 root_level;       // Level of first proper decision (the assumptions all share level 1, see 'solve()').
+    int                 chrono_lim;       // (During 'search()' only.) 'SearchParams::chrono', or 0 when logging proofs. Literals on the trail may then be of lower levels than their position says.
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplifyDB()'.
     int64               simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplifyDB()'.
+    int64               subsume_conflicts;// 'simplifyDB()' runs 'subsume()' again once 'stats.conflicts' reaches this...
+    int                 subsume_assigns;  // ...or the number of top-level assignments reaches this.
+    int64               conflict_lim;     // Absolute value of 'stats.conflicts' at which the current 'solve()' gives up (-1 = no limit).
+    int64               propagation_lim;  // Absolute value of 'stats.propagations' at which the current 'solve()' gives up (-1 = no limit).
+    double              time_lim;         // 'realTime()' at which the current 'solve()' gives up (-1 = no limit).
+    int                 time_check;       // Counter to sample the clock only every so often.
+    bool                limit_reached;    // Set when the budget of the current 'solve()' is used up.
+    BoundedQueue        lbd_queue;        // LBDs of the latest conflicts (for 'restart_Glucose').
+    BoundedQueue        trail_queue;      // Trail sizes at the latest conflicts (for restart blocking).
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which is used:
     //
     vec<char>           analyze_seen;
     vec<Lit>            analyze_stack;
     vec<Lit>            analyze_toclear;
-    Clause*             propagate_tmpbin;
-    Clause*             analyze_tmpbin;
+    vec<Lit>            cancelUntil_kept;
+    vec<uint>           computeLbd_seen;  // (indexed by decision level)
+    uint                computeLbd_stamp;
+    CRef                propagate_tmpbin;
+    CRef                analyze_tmpbin;
     vec<Lit>            addUnit_tmp;
     vec<Lit>            addBinary_tmp;
     vec<Lit>            addTernary_tmp;
+    vec<Lit>            eliminateVar_pos;
+    vec<Lit>            eliminateVar_neg;
+    vec<Lit>            eliminateVar_resolvent;
+    vec<Lit>            substitute_lits;
+    vec<Lit>            probe_saved;
+    vec<char>           subsume_seen;     // (indexed by literal)
+    vec<Lit>            vivify_lits;
+    vec<Lit>            vivify_order;
 
     // Main internal methods:
     //
@@ -91,15 +219,47 @@ protected:
     void        cancelUntil      (int level);
     void        record           (const vec<Lit>& clause);
 
-    void        analyze          (Clause* confl, vec<Lit>& out_learnt, int& out_btlevel); // (bt = backtrack)
+    void        analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& out_lbd); // (bt = backtrack)
     bool        analyze_removable(Lit p, uint min_level);                                 // (helper method for 'analyze()')
-    void        analyzeFinal     (Clause* confl, bool skip_first = false);
-    bool        enqueue          (Lit fact, Clause* from = NULL);
-    Clause*     propagate        ();
+    void        analyze_binMinimize(vec<Lit>& out_learnt);                                // (helper method for 'analyze()')
+    void        strengthenReason (CRef cr);                                               // (helper method for 'analyze()')
+    void        analyzeFinal     (CRef confl, bool skip_first = false);
+    bool        enqueue          (Lit fact, GClause from = GClause_NULL, int level = -1);
+    CRef        propagate        ();
+    void        logUnit          (Clause& c);                                             // (helper method for 'propagate()')
+    CRef        reasonClause     (Var x);
+    ClauseId    binaryId         (Lit p, Lit q);
+    template<class Lits>
+    int         computeLbd       (const Lits& ps);
+    int         lbdTier          (int lbd) const { return lbd <= core_lbd ? tier_Core : lbd <= mid_lbd ? tier_Mid : tier_Local; }
     void        reduceDB         ();
+    void        checkGarbage     ();
+    void        garbageCollect   ();
+    void        relocAll         (ClauseAllocator& to);
     Lit         pickBranchLit    (const SearchParams& params);
+    Lit         phaseLit         (Var x, const SearchParams& params);
+    bool        justified        (Var x);
+    Lit         pickJustifyLit   (const SearchParams& params);
+    void        saveTarget       ();
+    void        rephase          (const SearchParams& params);
     lbool       search           (int nof_conflicts, int nof_learnts, const SearchParams& params);
+    bool        backtrackToConflict(CRef confl);                                          // (helper method for 'search()')
     double      progressEstimate ();
+    bool        eliminateVar     (Var v);
+    int         collectClauses   (Lit p, vec<Lit>& out);                                  // (helper method for 'eliminateVar()')
+    bool        merge            (const Lit* a, const Lit* b, vec<Lit>& out);             // (helper method for 'eliminateVar()')
+    void        removeClauses    (Lit p);                                                 // (helper method for 'eliminateVar()')
+    void        extendModel      ();
+    void        saveModel        ();
+    void        substitute       ();                                                      // (helper method for 'inprocess()')
+    void        findEquivalences (vec<Lit>& repr);                                        // (helper method for 'substitute()')
+    void        addRewritten     (vec<Lit>& ps, CRef from);                               // (helper method for 'substitute()')
+    void        probe            (int64 budget);                                          // (helper method for 'inprocess()')
+    void        subsume          ();                                                      // (helper method for 'simplifyDB()')
+    bool        strengthenBy     (CRef cr, Lit p, ClauseId by);                           // (helper method for 'subsume()')
+    void        recoverXors      ();
+    void        gaussXors        ();
+    bool        withinLimits     ();
 
     // Activity:
     //
@@ -114,11 +274,14 @@ protected:
 
     // Operations on clauses:
     //
-    void     newClause(const vec<Lit>& ps, bool learnt = false, ClauseId id = ClauseId_NULL, bool A = true);
-    void     claBumpActivity (Clause* c) { if ( (c->activity() += cla_inc) > 1e20 ) claRescaleActivity(); }
-    void     remove          (Clause* c, bool just_dealloc = false);
-    bool     locked          (const Clause* c) const { return reason[var((*c)[0])] == c; }
-    bool     simplify        (Clause* c) const;
+    void     newClause(const vec<Lit>& ps, bool learnt = false, ClauseId id = ClauseId_NULL, bool A = true, int lbd = 0);
+    void     claBumpActivity (Clause& c) { if ( (c.activity() += cla_inc) > 1e20 ) claRescaleActivity(); }
+    void     claUpdateLbd    (Clause& c);
+    void     remove          (CRef cr, bool just_dealloc = false);
+    void     newXor          (const vec<Lit>& ps);
+    void     removeXor       (CRef cr);
+    bool     locked          (CRef cr) const { return vardata[var(ca[cr][0])].reason == GClause_new(cr); }
+    bool     simplify        (CRef cr) const;
 
     int      decisionLevel() const { return trail_lim.size(); }
 
@@ -128,42 +291,78 @@ public:
              , cla_decay        (1)
              , var_inc          (1)
              , var_decay        (1)
-             , order            (assigns, activity)
+             , order            (assigns, decision, activity)
+             , n_bin_clauses    (0)
+             , xors_recovered   (false)
+             , gauss_dirty      (false)
+             , target_size      (0)
+             , target_saved     (0)
+             , next_rephase     (0)
+             , rephase_count    (0)
+             , justify_head     (0)
+             , fallback_next    (0)
+             , n_eliminated     (0)
+             , inprocess_bins   (-1)
+             , inprocess_assigns(-1)
+             , inprocess_props  (0)
+             , probe_next       (0)
+             , probe_sweep      (0)
+             , chrono_lim       (0)
              , qhead            (0)
              , simpDB_assigns   (0)
              , simpDB_props     (0)
+             , subsume_conflicts(0)
+             , subsume_assigns  (0)
+             , conflict_lim     (-1)
+             , propagation_lim  (-1)
+             , time_lim         (-1)
+             , time_check       (0)
+             , limit_reached    (false)
+             , lbd_queue        (50)
+             , trail_queue      (5000)
              , default_params   (SearchParams(0.95, 0.999, 0.02))
              , expensive_ccmin  (2)
+             , garbage_frac     (0.20)
+             , core_lbd         (2)
+             , mid_lbd          (6)
+             , elim_clause_lim  (20)
+             , elim_resolve_lim (400)
+             , probe_effort     (0.1)
+             , native_xor       (false)
+             , gauss_max_rows   (1000)
+             , subsume_interval (5000)
+             , subsume_occ_lim  (1000)
+             , full_model       (true)
              , proof            (NULL)
              , verbosity        (0)
              , progress_estimate(0)
              , conflict_id      (ClauseId_NULL)
              {
                 vec<Lit> dummy(2,lit_Undef);
-                propagate_tmpbin = Clause_new(false, dummy);
-                analyze_tmpbin   = Clause_new(false, dummy);
+                propagate_tmpbin = ca.alloc(false, dummy, 0);       // (with room for an ID when proof logging)
+                analyze_tmpbin   = ca.alloc(false, dummy, 0);
                 addUnit_tmp   .growTo(1);
                 addBinary_tmp .growTo(2);
                 addTernary_tmp.growTo(3);
+                for (int t = 0; t < 3; t++) learnts_tier[t] = 0;
+                computeLbd_seen.push(0);
+                computeLbd_stamp = 0;
              }
 
-   ~Solver() {
-       for (int i = 0; i < learnts.size(); i++) remove(learnts[i], true);
-       for (int i = 0; i < clauses.size(); i++) if (clauses[i] != NULL) remove(clauses[i], true);
-       remove(propagate_tmpbin, true);
-       remove(analyze_tmpbin, true);
-    }
+   ~Solver() { }     // (all clauses live in 'ca')
 
     // Helpers: (semi-internal)
     //
     lbool   value(Var x) const { return toLbool(assigns[x]); }
     lbool   value(Lit p) const { return sign(p) ? ~toLbool(assigns[var(p)]) : toLbool(assigns[var(p)]); }
-    lbool   modelValue(Var x) const { return model[x]; }
+    lbool   modelValue(Var x) const { return x < model.size() ? model[x] : l_Undef; }   // ('l_Undef' for all variables without 'full_model')
 //    lbool   modelValue(Lit p) const { return model[var(p)] ^ sign(p); }
 
     int     nAssigns() { return trail.size(); }
-    int     nClauses() { return clauses.size(); }
+    int     nClauses() { return clauses.size() + n_bin_clauses; }
     int     nLearnts() { return learnts.size(); }
+    int     nXors   () { return xors.size(); }
+    int     nLearnts(int tier) { return learnts_tier[tier]; }
 
     // Statistics: (read-only member variable)
     //
@@ -173,24 +372,49 @@ public:
     //
     SearchParams    default_params;     // Restart frequency etc.
     int             expensive_ccmin;    // Controls conflict clause minimization. TRUE by default.
+    double          garbage_frac;       // Collect the clause region when this fraction of it is wasted. 0.20 by default.
+    int             core_lbd;           // Learnt clauses with LBD up to this are kept longest (core tier). 2 by default.
+    int             mid_lbd;            // Learnt clauses with LBD up to this are kept while they are used (mid tier). 6 by default.
+    int             elim_clause_lim;    // 'eliminate()' keeps variables that would produce a resolvent longer than this. 20 by default.
+    int             elim_resolve_lim;   // 'eliminate()' keeps variables with more pairs of clauses to resolve than this. 400 by default.
+    double          probe_effort;       // 'inprocess()' probes for this fraction of the propagations made since its last call (at least 10000). 0.1 by default.
+    bool            native_xor;         // Keep XOR constraints as such ('addXor()', 'recoverXors()') rather than as clauses. FALSE by default.
+    int             gauss_max_rows;     // 'gaussXors()' skips clusters of more XOR constraints than this. 1000 by default.
+    int             subsume_interval;   // 'simplifyDB()' looks for subsumed clauses again after this many conflicts, or a tenth as many new top-level facts. 5000 by default.
+    int             subsume_occ_lim;    // 'subsume()' does not search occurrence lists longer than this. 1000 by default.
+    bool            full_model;         // Copy every variable to 'model' when a model is found, else only the projection (see 'setProjection()'). TRUE by default.
     Proof*          proof;              // Set this directly after constructing 'Solver' to enable proof logging. Initialized to NULL.
     int             verbosity;          // Verbosity level. 0=silent, 1=some progress report, 2=everything
 
     // Problem specification:
     //
-    Var     newVar    ();
+    Var     newVar    (bool dvar = true);
+    void    setDecisionVar(Var x, bool b);  // Only decision variables are branched on (see 'pickBranchLit()').
+    void    addGate   (Var x, int type, Lit a, Lit b) { gates[x] = Gate(type, a, b); }   // Structure for 'SearchParams::justify' (the clauses are added separately).
     int     nVars     ()                    { return assigns.size(); }
     void    addUnit   (Lit p)               { addUnit_tmp   [0] = p; addClause(addUnit_tmp); }
     void    addBinary (Lit p, Lit q)        { addBinary_tmp [0] = p; addBinary_tmp [1] = q; addClause(addBinary_tmp); }
     void    addTernary(Lit p, Lit q, Lit r) { addTernary_tmp[0] = p; addTernary_tmp[1] = q; addTernary_tmp[2] = r; addClause(addTernary_tmp); }
     void    addClause (const vec<Lit>& ps , bool A = true)  { newClause(ps , false , ClauseId_NULL , A); }  
-	 // (used to be a difference between internal and external method...)
+    // (used to be a difference between internal and external method...)
+    void    releaseVar(Lit p)               { addUnit(p); simpDB_props = 0; }  // Make 'p' true for good (e.g. to switch off the clauses guarded by '~p'); the next 'simplifyDB()' removes the clauses it satisfies.
+    void    addXor    (const vec<Lit>& ps)  { newXor(ps); }     // The XOR of 'ps' is true (e.g. '~f, a, b' for 'f = a XOR b').
+    void    seedPhase (Var x, bool value)   { seed_polarity[x] = polarity[x] = target_polarity[x] = !value; }   // Preferred first value of 'x' for decisions.
+    void    setFrozen (Var x, bool b)       { frozen[x] = b; }     // Keep 'x' through 'eliminate()' and 'inprocess()' (variables assumed or added to clauses later). Set false if the search has to branch on it (see 'pickBranchLit()').
+    bool    isEliminated(Var x) const       { return eliminated[x]; }
+    void    setProjection(const vec<Var>& xs) { xs.copyTo(projection); }   // Variables read through 'projectedModel()', which is kept even without 'full_model'.
+    void    projectedModel(vec<uint64>& bits) const { proj_model.copyTo(bits); }   // Bit 'i' is the value of 'projection[i]' in the model of the last satisfiable 'solve()'.
+    int     nEliminated() const             { return n_eliminated; }
 
     // Solving:
     //
     bool    okay() { return ok; }       // FALSE means solver is in an conflicting state (must never be used again!)
     void    simplifyDB();
-    bool    solve(const vec<Lit>& assumps);
+    bool    eliminate ();               // Bounded variable elimination of the non-frozen variables. FALSE if the problem turned out unsatisfiable.
+    bool    inprocess ();               // Equivalent-literal substitution and failed-literal probing between 'solve()' calls. FALSE if unsatisfiable.
+    bool    vivify    (double seconds); // Shorten the best learnt clauses for up to 'seconds' between 'solve()' calls. FALSE if unsatisfiable.
+    lbool   solve(const vec<Lit>& assumps, const SolveLimits& limits);   // 'l_Undef' if the limits were reached before an answer was found.
+    bool    solve(const vec<Lit>& assumps) { return solve(assumps, SolveLimits()) == l_True; }
     bool    solve() { vec<Lit> tmp; return solve(tmp); }
 
     double      progress_estimate;  // Set by 'search()'.
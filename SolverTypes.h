@@ -81,60 +81,179 @@ const   int ClauseId_NULL = INT_MIN;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+// Tiers of learnt clauses (see 'Solver::reduceDB()'):
+const int tier_Core  = 0;
+const int tier_Mid   = 1;
+const int tier_Local = 2;
+
 class Clause {
-    uint    size_learnt;
+    uint    header;     // size << 14 | vivified << 13 | xor << 12 | lbd << 7 | used << 5 | tier << 3 | reloced << 2 | has_id << 1 | learnt
     Lit     data[1];
 public:
-    // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
+    enum { max_size = (1 << 18) - 1, max_lbd = 31, max_used = 3 };
+
+    // NOTE: These constructors cannot be used directly (don't allocate enough memory).
     Clause(bool learnt, const vec<Lit>& ps, ClauseId id_ = ClauseId_NULL) {
-        size_learnt = (ps.size() << 1) | (int)learnt;
+        assert(ps.size() <= max_size);
+        header = (ps.size() << 14) | ((int)(id_ != ClauseId_NULL) << 1) | (int)learnt;
         for (int i = 0; i < ps.size(); i++) data[i] = ps[i];
         if (learnt) activity() = 0;
         if (id_ != ClauseId_NULL) id() = id_; }
+    Clause(const Clause& from) {
+        header = from.header;
+        for (int i = 0; i < size() + (int)learnt() + (int)hasId(); i++) data[i] = from.data[i]; }
 
-    // -- use this function instead:
-    friend Clause* Clause_new(bool, const vec<Lit>&, ClauseId);
+    // -- use 'ClauseAllocator::alloc()' instead:
+    friend class ClauseAllocator;
 
-    int       size        ()      const { return size_learnt >> 1; }
-    bool      learnt      ()      const { return size_learnt & 1; }
+    int       size        ()      const { return header >> 14; }
+    bool      learnt      ()      const { return header & 1; }
+    bool      hasId       ()      const { return header & 2; }
     Lit       operator [] (int i) const { return data[i]; }
     Lit&      operator [] (int i)       { return data[i]; }
     float&    activity    ()      const {
         void *p = const_cast<Lit*>(&data[size()]); return *((float *)p);
     } //              return *((float*)&data[size()]); }
     ClauseId& id          ()      const { return *((ClauseId*)&data[size() + (int)learnt()]); }
+
+    // Learnt clauses only: literal block distance (saturates at 'max_lbd'), tier and the number of
+    // 'reduceDB()' rounds the clause survives without taking part in conflict analysis.
+    int       lbd         ()      const { return (header >> 7) & max_lbd; }
+    int       tier        ()      const { return (header >> 3) & 3; }
+    int       used        ()      const { return (header >> 5) & max_used; }
+    void      setLbd      (int l)       { header = (header & ~(max_lbd << 7)) | ((l < max_lbd ? l : max_lbd) << 7); }
+    void      setTier     (int t)       { header = (header & ~(3 << 3)) | (t << 3); }
+    void      setUsed     (int u)       { header = (header & ~(max_used << 5)) | (u << 5); }
+
+    // Remove the literal at position 'i' (the last literal takes its place). Use
+    // 'ClauseAllocator::strengthen()', which accounts for the word given up.
+    void      strengthen  (int i)       {
+        int n = size() - 1;
+        data[i] = data[n];
+        for (int k = 0; k < (int)learnt() + (int)hasId(); k++) data[n + k] = data[n + 1 + k];
+        header = (header & ((1 << 14) - 1)) | (n << 14); }
+
+    // XOR constraints (see 'Solver::addXor()'): the XOR of the literals is true. The literals
+    // are negated in pairs during propagation, so that they also read as one of its clauses.
+    bool      isXor       ()      const { return header & (1 << 12); }
+    void      setXor      ()            { header |= 1 << 12; }
+
+    // Learnt clauses already tried by 'Solver::vivify()':
+    bool      vivified    ()      const { return header & (1 << 13); }
+    void      setVivified ()            { header |= 1 << 13; }
+
+    // Garbage collection: a moved clause keeps its new location in 'data[0]'.
+    bool      reloced     ()      const { return header & 4; }
+    uint      relocation  ()      const { return (uint)index(data[0]); }
+    void      relocate    (uint to)     { header |= 4; data[0] = toLit((int)to); }
+};
+
+
+//=================================================================================================
+// ClauseAllocator -- all clauses are stored back to back in one growable region:
+
+
+// Clauses are referred to by their 32-bit word offset into the region. Freed clauses are only
+// counted as wasted; the space is reclaimed by moving the live clauses into a new region.
+typedef uint CRef;
+const   CRef CRef_Undef = UINT_MAX;
+
+class ClauseAllocator {
+    uint*   memory;
+    uint    sz;
+    uint    cap;
+    uint    wasted_;
+
+    static uint words(int size, bool learnt, bool has_id) { return (sizeof(Clause) - sizeof(Lit)) / sizeof(uint) + size + (int)learnt + (int)has_id; }
+    static uint words(const Clause& c)                      { return words(c.size(), c.learnt(), c.hasId()); }
+
+    uint grab(uint n) {
+        assert(sizeof(Lit)      == sizeof(uint));
+        assert(sizeof(float)    == sizeof(uint));
+        assert(sizeof(ClauseId) == sizeof(uint));
+        if (sz + n > cap){
+            while (sz + n > cap){
+                uint delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+                assert(cap + delta > cap);      // (out of 32-bit references)
+                cap += delta; }
+            memory = xrealloc(memory, cap); }
+        uint r = sz; sz += n;
+        return r; }
+
+public:
+    ClauseAllocator(uint start_cap = 0) : memory(xmalloc<uint>(start_cap)), sz(0), cap(start_cap), wasted_(0) { }
+   ~ClauseAllocator() { xfree(memory); }
+
+    // NOTE! Allocation may move the region; references obtained with '[]' are invalidated.
+    CRef alloc(bool learnt, const vec<Lit>& ps, ClauseId id = ClauseId_NULL) {
+        CRef r = grab(words(ps.size(), learnt, id != ClauseId_NULL));
+        new (&memory[r]) Clause(learnt, ps, id);
+        return r; }
+    CRef alloc(const Clause& from) {
+        CRef r = grab(words(from));
+        new (&memory[r]) Clause(from);
+        return r; }
+    void free(CRef r) { wasted_ += words((*this)[r]); }
+    void strengthen(CRef r, int i) { (*this)[r].strengthen(i); wasted_++; }
+
+    Clause&       operator [] (CRef r)       { return (Clause&)memory[r]; }
+    const Clause& operator [] (CRef r) const { return (const Clause&)memory[r]; }
+
+    uint size  () const { return sz; }
+    uint wasted() const { return wasted_; }
+
+    // Move a clause to 'to' (only once -- later calls just update the reference):
+    void reloc(CRef& r, ClauseAllocator& to) {
+        Clause& c = (*this)[r];
+        if (c.reloced()){ r = c.relocation(); return; }
+        CRef nr = to.alloc(c);
+        c.relocate(nr);
+        r = nr; }
+
+    // Hand over the region to 'to' (which is cleared first), leaving this allocator empty:
+    void moveTo(ClauseAllocator& to) {
+        xfree(to.memory);
+        to.memory = memory; to.sz = sz; to.cap = cap; to.wasted_ = wasted_;
+        memory = NULL; sz = cap = wasted_ = 0; }
 };
 
-inline Clause* Clause_new(bool learnt, const vec<Lit>& ps, ClauseId id = ClauseId_NULL) {
-    assert(sizeof(Lit)      == sizeof(uint));
-    assert(sizeof(float)    == sizeof(uint));
-    assert(sizeof(ClauseId) == sizeof(uint));
-    void*   mem = xmalloc<char>(sizeof(Clause) + sizeof(uint)*(ps.size() + (int)learnt + (int)(id != ClauseId_NULL)));
-    return new (mem) Clause(learnt, ps, id); }
+
+//=================================================================================================
+// Watcher -- an element of a watcher list:
+
+
+// The clause together with a "blocker" literal from it. If the blocker is true, the clause is
+// satisfied and need not be visited during propagation.
+struct Watcher {
+    CRef    cref;
+    Lit     blocker;
+    Watcher() : cref(CRef_Undef), blocker(lit_Undef) {}
+    Watcher(CRef c, Lit p) : cref(c), blocker(p) {}
+};
 
 
 //=================================================================================================
 // GClause -- Generalize clause:
 
 
-// Either a pointer to a clause or a literal.
+// Either a clause reference or a literal (packed into 32 bits).
 class GClause {
-    void*   data;
-    GClause(void* d) : data(d) {}
+    uint    data;
+    GClause(uint d) : data(d) {}
 public:
     friend GClause GClause_new(Lit p);
-    friend GClause GClause_new(Clause* c);
+    friend GClause GClause_new(CRef c);
 
-    bool        isLit    () const { return ((uintp)data & 1) == 1; }
-    Lit         lit      () const { return toLit(((intp)data) >> 1); }
-    Clause*     clause   () const { return (Clause*)data; }
+    bool        isLit    () const { return (data & 1) == 1; }
+    Lit         lit      () const { return toLit(((int)data) >> 1); }
+    CRef        clause   () const { return (CRef)(((int)data) >> 1); }     // (arithmetic shift maps 'GClause_NULL' back to 'CRef_Undef')
     bool        operator == (GClause c) const { return data == c.data; }
     bool        operator != (GClause c) const { return data != c.data; }
 };
-inline GClause GClause_new(Lit p)     { return GClause((void*)(((intp)index(p) << 1) + 1)); }
-inline GClause GClause_new(Clause* c) { assert(((uintp)c & 1) == 0); return GClause((void*)c); }
+inline GClause GClause_new(Lit p)  { return GClause(((uint)index(p) << 1) + 1); }
+inline GClause GClause_new(CRef c) { assert(c == CRef_Undef || c < (1u << 30)); return GClause(c << 1); }
 
-#define GClause_NULL GClause_new((Clause*)NULL)
+#define GClause_NULL GClause_new(CRef_Undef)
 
 
 //=================================================================================================
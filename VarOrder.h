@@ -22,6 +22,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include "SolverTypes.h"
 #include "Heap.h"
+#include "Sort.h"
 
 
 //=================================================================================================
@@ -33,59 +34,161 @@ struct VarOrder_lt {
     VarOrder_lt(const vec<double>&  act) : activity(act) { }
 };
 
+struct VarOrder_stamp_lt {
+    const vec<int64>&   stamp;
+    bool operator () (Var x, Var y) { return stamp[x] < stamp[y]; }
+    VarOrder_stamp_lt(const vec<int64>& s) : stamp(s) { }
+};
+
+// Two interchangeable orders: VSIDS (a heap on activity) and VMTF ("variable move-to-front", a
+// queue where bumped variables are moved to the end). In VMTF mode the heap is not maintained and
+// vice versa; 'setVmtf()' rebuilds the one switched to. Only decision variables are selected.
+//
 class VarOrder {
     const vec<char>&    assigns;     // var->val. Pointer to external assignment table.
-//    const vec<double>&  activity;    // var->act. Pointer to external activity table.
+    const vec<char>&    decision;    // var->bool. Pointer to external decision variable table.
+    const vec<double>&  activity;    // var->act. Pointer to external activity table.
     Heap<VarOrder_lt>   heap;
     double              random_seed; // For the internal random number generator
 
+    bool                vmtf;        // Use the queue below instead of the heap?
+    vec<Var>            vmtf_prev;   // }- Doubly linked queue of all variables, most recently bumped last.
+    vec<Var>            vmtf_next;   // }
+    vec<int64>          vmtf_stamp;  // Enqueue time of each variable (increasing towards 'vmtf_last').
+    Var                 vmtf_first, vmtf_last;
+    Var                 vmtf_search; // All variables after this one in the queue are assigned.
+    int64               vmtf_stamps;
+    vec<Var>            vmtf_bumped; // Variables bumped since the last 'flush()'.
+
+    inline void vmtfDequeue(Var x);
+    inline void vmtfEnqueue(Var x);  // (at the end)
+
 public:
-    VarOrder(const vec<char>& ass, const vec<double>& act) :
-//        assigns(ass), activity(act), heap(VarOrder_lt(act)), random_seed(91648253)
-        assigns(ass), heap(VarOrder_lt(act)), random_seed(91648253)
+    VarOrder(const vec<char>& ass, const vec<char>& dec, const vec<double>& act) :
+        assigns(ass), decision(dec), activity(act), heap(VarOrder_lt(act)), random_seed(91648253)
+      , vmtf(false), vmtf_first(var_Undef), vmtf_last(var_Undef), vmtf_search(var_Undef), vmtf_stamps(0)
         { }
 
     inline void newVar(void);
     inline void update(Var x);                  // Called when variable increased in activity.
+    inline void flush(void);                    // Called after a batch of 'update()'s (VMTF: moves the bumped variables).
     inline void undo(Var x);                    // Called when variable is unassigned and may be selected again.
+    inline void setDecision(Var x);             // Called when the decision flag of variable changed.
     inline Var  select(double random_freq =.0); // Selects a new, unassigned variable (or 'var_Undef' if none exists).
+
+    bool        isVmtf (void) const { return vmtf; }
+    inline void setVmtf(bool on);               // Switch order; the new one starts from the current activities.
 };
 
 
+void VarOrder::vmtfDequeue(Var x)
+{
+    if (vmtf_prev[x] != var_Undef) vmtf_next[vmtf_prev[x]] = vmtf_next[x]; else vmtf_first = vmtf_next[x];
+    if (vmtf_next[x] != var_Undef) vmtf_prev[vmtf_next[x]] = vmtf_prev[x]; else vmtf_last  = vmtf_prev[x];
+}
+
+
+void VarOrder::vmtfEnqueue(Var x)
+{
+    vmtf_prev[x] = vmtf_last;
+    vmtf_next[x] = var_Undef;
+    if (vmtf_last != var_Undef) vmtf_next[vmtf_last] = x; else vmtf_first = x;
+    vmtf_last     = x;
+    vmtf_stamp[x] = ++vmtf_stamps;
+    if (toLbool(assigns[x]) == l_Undef || vmtf_search == var_Undef)
+        vmtf_search = x;
+}
+
+
 void VarOrder::newVar(void)
 {
     heap.setBounds(assigns.size());
-    heap.insert(assigns.size()-1);
+    vmtf_prev .push();
+    vmtf_next .push();
+    vmtf_stamp.push();
+    Var x = assigns.size()-1;
+    if (!decision[x]) return;
+    if (vmtf) vmtfEnqueue(x);
+    else      heap.insert(x);
 }
 
 
 void VarOrder::update(Var x)
 {
-    if (heap.inHeap(x))
+    if (vmtf){
+        if (decision[x]) vmtf_bumped.push(x);
+    }else if (heap.inHeap(x))
         heap.increase(x);
 }
 
 
+void VarOrder::flush(void)
+{
+    if (vmtf_bumped.size() == 0) return;
+
+    // Move to the end, keeping the relative order of the bumped variables:
+    sort(vmtf_bumped, VarOrder_stamp_lt(vmtf_stamp));
+    for (int i = 0; i < vmtf_bumped.size(); i++){
+        Var x = vmtf_bumped[i];
+        if (x == vmtf_last){
+            if (toLbool(assigns[x]) == l_Undef) vmtf_search = x;
+            continue; }
+        vmtfDequeue(x);
+        vmtfEnqueue(x);
+    }
+    vmtf_bumped.clear();
+}
+
+
 void VarOrder::undo(Var x)
 {
-    if (!heap.inHeap(x))
+    if (!decision[x]) return;
+    if (vmtf){
+        if (vmtf_stamp[x] > vmtf_stamp[vmtf_search])
+            vmtf_search = x;
+    }else if (!heap.inHeap(x))
+        heap.insert(x);
+}
+
+
+void VarOrder::setDecision(Var x)
+{
+    if (vmtf){
+        if (decision[x])
+            vmtfEnqueue(x);
+        else{
+            if (x == vmtf_search) vmtf_search = (vmtf_prev[x] != var_Undef) ? vmtf_prev[x] : vmtf_next[x];
+            vmtfDequeue(x);
+            if (vmtf_search == var_Undef) vmtf_search = vmtf_first;
+        }
+    }else if (decision[x] && toLbool(assigns[x]) == l_Undef && !heap.inHeap(x))
         heap.insert(x);
+    // (non-decision variables are left in the heap and skipped by 'select()')
 }
 
 
 Var VarOrder::select(double random_var_freq)
 {
     // Random decision:
-    if (drand(random_seed) < random_var_freq && !heap.empty()){
+    if (drand(random_seed) < random_var_freq && (vmtf ? assigns.size() > 0 : !heap.empty())){
         Var next = irand(random_seed,assigns.size());
-        if (toLbool(assigns[next]) == l_Undef)
+        if (toLbool(assigns[next]) == l_Undef && decision[next])
             return next;
     }
 
+    if (vmtf){
+        // Most recently bumped unassigned variable:
+        Var next = vmtf_search;
+        while (next != var_Undef && toLbool(assigns[next]) != l_Undef)
+            next = vmtf_prev[next];
+        vmtf_search = (next == var_Undef) ? vmtf_first : next;
+        return next;
+    }
+
     // Activity based decision:
     while (!heap.empty()){
         Var next = heap.getmin();
-        if (toLbool(assigns[next]) == l_Undef)
+        if (toLbool(assigns[next]) == l_Undef && decision[next])
             return next;
     }
 
@@ -93,5 +196,30 @@ Var VarOrder::select(double random_var_freq)
 }
 
 
+void VarOrder::setVmtf(bool on)
+{
+    if (on == vmtf) return;
+    vmtf = on;
+    vmtf_bumped.clear();
+
+    if (vmtf){
+        // Queue all variables by increasing activity:
+        vec<Var> vs;
+        for (Var x = 0; x < assigns.size(); x++) if (decision[x]) vs.push(x);
+        sort(vs, VarOrder_lt(activity));
+        vmtf_first = vmtf_last = vmtf_search = var_Undef;
+        for (int i = vs.size()-1; i >= 0; i--)
+            vmtfEnqueue(vs[i]);
+        if (vmtf_search == var_Undef) vmtf_search = vmtf_first;
+    }else{
+        // The heap missed all bumps and unassignments in VMTF mode:
+        heap.clear();
+        for (Var x = 0; x < assigns.size(); x++)
+            if (toLbool(assigns[x]) == l_Undef && decision[x])
+                heap.insert(x);
+    }
+}
+
+
 //=================================================================================================
 #endif
@@ -11,6 +11,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <vector>
 #include "Solver.h"
 
 using namespace std;
@@ -19,7 +20,7 @@ using namespace std;
 class SatSolver
 {
    public : 
-      SatSolver():_solver(0) { }
+      SatSolver():_solver(0), _group(-1) { }
       ~SatSolver() { if (_solver) delete _solver; }
 
       // Solver initialization and reset
@@ -30,40 +31,100 @@ class SatSolver
       void reset() {
          if (_solver) delete _solver;
          _solver = new Solver();
-         _assump.clear(); _curVar = 0;
+         _assump.clear(); _curVar = 0; _hash = 14695981039346656037ULL;
+         _groups.clear(); _group = -1;
       }
 
       // Constructing proof model
-      // Return the Var ID of the new Var
-      inline Var newVar() { _solver->newVar(); return _curVar++; }
+      // Return the Var ID of the new Var; "dvar" = false keeps it out of the decisions
+      // (for variables that follow from others by propagation, e.g. gate outputs)
+      inline Var newVar(bool dvar = true) { _solver->newVar(dvar); hashInt(1); return _curVar++; }
+      void setDecisionVar(Var v, bool dvar) { _solver->setDecisionVar(v, dvar); }
+      int nVars() const { return _curVar; }
       // fa/fb = true if it is inverted
       void addAigCNF(Var vf, Var va, bool fa, Var vb, bool fb) {
+         hashInt(2); hashInt(vf); hashInt(va); hashInt(fa); hashInt(vb); hashInt(fb);
          vec<Lit> lits;
          Lit lf = Lit(vf);
          Lit la = fa? ~Lit(va): Lit(va);
          Lit lb = fb? ~Lit(vb): Lit(vb);
+         if (_group < 0) _solver->addGate(vf, gate_And, la, lb);
          lits.push(la); lits.push(~lf);
-         _solver->addClause(lits); lits.clear();
+         addGroupClause(lits); lits.clear();
          lits.push(lb); lits.push(~lf);
-         _solver->addClause(lits); lits.clear();
+         addGroupClause(lits); lits.clear();
          lits.push(~la); lits.push(~lb); lits.push(lf);
-         _solver->addClause(lits); lits.clear();
+         addGroupClause(lits); lits.clear();
       }
       // fa/fb = true if it is inverted
       void addXorCNF(Var vf, Var va, bool fa, Var vb, bool fb) {
+         hashInt(3); hashInt(vf); hashInt(va); hashInt(fa); hashInt(vb); hashInt(fb);
          vec<Lit> lits;
          Lit lf = Lit(vf);
          Lit la = fa? ~Lit(va): Lit(va);
          Lit lb = fb? ~Lit(vb): Lit(vb);
+         if (_group < 0) {
+            _solver->addGate(vf, gate_Xor, la, lb);
+            // a ^ b ^ ~f is true; kept as one XOR constraint, or as its 4 clauses
+            lits.push(~lf); lits.push( la); lits.push( lb);
+            _solver->addXor(lits);
+            return;
+         }
          lits.push(~la); lits.push( lb); lits.push( lf);
-         _solver->addClause(lits); lits.clear();
+         addGroupClause(lits); lits.clear();
          lits.push( la); lits.push(~lb); lits.push( lf);
-         _solver->addClause(lits); lits.clear();
+         addGroupClause(lits); lits.clear();
          lits.push( la); lits.push( lb); lits.push(~lf);
-         _solver->addClause(lits); lits.clear();
+         addGroupClause(lits); lits.clear();
          lits.push(~la); lits.push(~lb); lits.push(~lf);
-         _solver->addClause(lits); lits.clear();
+         addGroupClause(lits); lits.clear();
       }
+      // Keep XOR gates as native constraints (off by default); call before the model is built
+      void setNativeXor(bool b) { _solver->native_xor = b; }
+      int nXors() const { return const_cast<Solver*>(_solver)->nXors(); }
+
+      // Clause groups: "addAigCNF()", "addXorCNF()" and "assertProperty()"
+      // between "beginGroup(g)" and "endGroup()" hold only in the queries that
+      // assume the group ("assumeGroup(g)"); "retireGroup(g)" drops them for
+      // good (the solver removes its clauses). Each group is guarded by an
+      // activation variable, which is frozen and not a decision variable: in
+      // a query that does not assume the group, it is set false only once
+      // everything else is assigned (the group's clauses are then satisfied)
+      int newGroup() {
+         Var act = newVar(false);
+         _solver->setFrozen(act, true);
+         _groups.push(act);
+         return _groups.size() - 1;
+      }
+      void beginGroup(int g) { assert(_groups[g] != var_Undef); hashInt(5); hashInt(g); _group = g; }
+      void endGroup() { hashInt(6); _group = -1; }
+      void assumeGroup(int g) { assert(_groups[g] != var_Undef); _assump.push(Lit(_groups[g])); }
+      void retireGroup(int g) {
+         assert(_groups[g] != var_Undef && _group != g);
+         hashInt(7); hashInt(g);
+         _solver->releaseVar(~Lit(_groups[g]));
+         _groups[g] = var_Undef;
+      }
+
+      // Keep "v" through "eliminate()": needed for every variable assumed or
+      // asserted afterwards (eliminated variables still get a value in the model)
+      void freeze(Var v) { _solver->setFrozen(v, true); }
+      // Bounded variable elimination; call once after the model is built
+      bool eliminate() { return _solver->eliminate(); }
+      int nEliminated() const { return _solver->nEliminated(); }
+      // Substitute equivalent signals and probe for failed literals; call
+      // between "assumpSolve()" calls (frozen variables are kept as well)
+      bool inprocess() { return _solver->inprocess(); }
+      // Shorten the most useful learnt clauses for up to "seconds"; call
+      // between "assumpSolve()" calls as well
+      bool vivify(double seconds) { return _solver->vivify(seconds); }
+      int nClauses() const { return const_cast<Solver*>(_solver)->nClauses(); }
+
+      // Search heuristics (restart policy etc.); call after "initialize()"
+      void setSearchParams(const SearchParams& params) { _solver->default_params = params; }
+      const SearchParams& getSearchParams() const { return _solver->default_params; }
+      // Preferred first value of "v" for decisions (e.g. from a known assignment)
+      void seedPhase(Var v, bool val) { _solver->seedPhase(v, val); }
 
       // For incremental proof, use "assumeSolve()"
       void assumeRelease() { _assump.clear(); }
@@ -71,10 +132,15 @@ class SatSolver
          _assump.push(val? Lit(prop): ~Lit(prop));
       }
       bool assumpSolve() { return _solver->solve(_assump); }
+      // Bounded version; l_Undef if the budget runs out before an answer
+      lbool assumpSolve(const SolveLimits& limits) { return _solver->solve(_assump, limits); }
 
       // For one time proof, use "solve"
       void assertProperty(Var prop, bool val) {
-         _solver->addUnit(val? Lit(prop): ~Lit(prop));
+         hashInt(4); hashInt(prop); hashInt(val);
+         vec<Lit> lits;
+         lits.push(val? Lit(prop): ~Lit(prop));
+         addGroupClause(lits);
       }
       bool solve() { _solver->solve(); return _solver->okay(); }
 
@@ -83,12 +149,43 @@ class SatSolver
       int getValue(Var v) const {
          return (_solver->modelValue(v)==l_True?1:
                 (_solver->modelValue(v)==l_False?0:-1)); }
+      // Projected model: a SAT result keeps one bit per variable of
+      // "setProjection()" (bit i = vars[i], see "getProjection()");
+      // "setFullModel(false)" skips copying all the other variables, whose
+      // "getValue()" is then -1
+      void setProjection(const vector<Var>& vars) {
+         vec<Var> xs;
+         for (int i=0; i<(int)vars.size(); i++) xs.push(vars[i]);
+         _solver->setProjection(xs);
+      }
+      void setFullModel(bool b) { _solver->full_model = b; }
+      void getProjection(vector<uint64>& bits) const {
+         vec<uint64> ws;
+         _solver->projectedModel(ws);
+         bits.assign(ws.size(), 0);
+         for (int i=0; i<ws.size(); i++) bits[i] = ws[i];
+      }
       void printStats() const { const_cast<Solver*>(_solver)->printStats(); }
+      const SolverStats& getStats() const { return _solver->stats; }
+      // Assumption literals responsible for the last UNSAT result of "assumpSolve()"
+      const vec<Lit>& getConflict() const { return _solver->conflict; }
+      // Hash over every variable and constraint added so far; identifies the compiled model
+      uint64 getModelHash() const { return _hash; }
 
    private : 
       Solver           *_solver;    // Pointer to a Minisat solver
       Var               _curVar;    // Variable currently
       vec<Lit>          _assump;    // Assumption List for assumption solve
+      uint64            _hash;      // FNV-1a hash of the model construction calls
+      vec<Var>          _groups;    // Activation variable of each clause group (var_Undef once retired)
+      int               _group;     // Group of the clauses added now (-1 = none)
+
+      void hashInt(int x) { _hash = (_hash ^ (uint64)(unsigned)x) * 1099511628211ULL; }
+      // Add "lits", guarded by the activation variable of the current group
+      void addGroupClause(vec<Lit>& lits) {
+         if (_group >= 0) lits.push(~Lit(_groups[_group]));
+         _solver->addClause(lits);
+      }
 };
 
 #endif  // SAT_H
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <sys/resource.h>
+
+// Solver benchmarks, run by "make bench". The CPU model is built with the converter's own
+// functions, so its main() is renamed here.
+#define main converter_main
+#include "SBST_converter.cpp"
+#undef main
+
+using namespace std;
+
+// xorshift64: the same queries on every run and every machine
+unsigned long long bench_seed = 88172645463325252ULL;
+unsigned long long BenchRandom() {
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 7;
+    bench_seed ^= bench_seed << 17;
+    return bench_seed;
+}
+
+// Gates for the multiplier workloads
+Var AddAnd(SatSolver& s, Var a, Var b) {
+    Var out = s.newVar();
+    s.addAigCNF(out, a, false, b, false);
+    return out;
+}
+
+Var AddXor(SatSolver& s, Var a, Var b) {
+    Var out = s.newVar();
+    s.addXorCNF(out, a, false, b, false);
+    return out;
+}
+
+Var AddOr(SatSolver& s, Var a, Var b) {
+    Var nor = s.newVar();
+    s.addAigCNF(nor, a, true, b, true);
+    Var out = s.newVar();
+    s.addAigCNF(out, nor, true, nor, true);
+    return out;
+}
+
+// Array multiplier of ripple-carry rows; the product has 2n bits
+vector<Var> AddMultiplier(SatSolver& s, vector<Var>& a, vector<Var>& b) {
+    int n = a.size();
+    Var zero = s.newVar();
+    s.assertProperty(zero, false);
+    vector<Var> acc(2*n, zero);
+    for (int i=0; i<n; i++) {
+        Var carry = zero;
+        for (int j=0; j<n; j++) {
+            Var pp = AddAnd(s, a[j], b[i]);
+            Var half = AddXor(s, acc[i+j], pp);
+            Var sum = AddXor(s, half, carry);
+            carry = AddOr(s, AddAnd(s, acc[i+j], pp), AddAnd(s, half, carry));
+            acc[i+j] = sum;
+        }
+        acc[i+n] = carry;
+    }
+    return acc;
+}
+
+// CPU model: each query assumes a random value for one in "density" frame-0 scan cells and
+// leaves the output free (asserted, as in the converter, every query is UNSAT at once)
+int BenchCPU(SatSolver& solver, int query_count, int density, double& run_time) {
+    fstream fin;
+    fin.open("CPU_com_syn.eq", ios::in);
+    vector<string> input_list;
+    vector<string> output_list;
+    map<string, Port> port_map;
+    map<Var, bool> base_assume_map;
+    map<string, string> DQ_map = ReadDictionary("CPU_DQ_map.txt");
+    map<string, string> DQN_map = ReadDictionary("CPU_DQN_map.txt");
+    map<string, string> DFF_pipeline_map = ReadDictionary("CPU_DFF_pipeline_map.txt");
+    streambuf* cout_buf = cout.rdbuf(0);
+    BuildEquation(solver, fin, input_list, port_map, output_list, DQ_map, DQN_map, base_assume_map);
+    cout.rdbuf(cout_buf);
+
+    double start_time = cpuTime();
+    int SAT_count = 0;
+    for (int q=0; q<query_count; q++) {
+        solver.assumeRelease();
+        for (auto i = DFF_pipeline_map.begin(); i != DFF_pipeline_map.end(); i++) {
+            unsigned long long r = BenchRandom();
+            if (r % density == 0) {
+                solver.assumeProperty(port_map[i->second].timeFrameVarList[0], (r >> 8) & 1);
+            }
+        }
+        SAT_count += solver.assumpSolve();
+    }
+    run_time = cpuTime() - start_time;
+    return SAT_count;
+}
+
+// Miter of a*b and b*a: UNSAT, and hard for its size
+int BenchMiter(SatSolver& solver, int n, double& run_time) {
+    vector<Var> a, b;
+    for (int i=0; i<n; i++) {
+        a.push_back(solver.newVar());
+        b.push_back(solver.newVar());
+    }
+    vector<Var> ab = AddMultiplier(solver, a, b);
+    vector<Var> ba = AddMultiplier(solver, b, a);
+    Var diff = AddXor(solver, ab[0], ba[0]);
+    for (int i=1; i<2*n; i++) {
+        diff = AddOr(solver, diff, AddXor(solver, ab[i], ba[i]));
+    }
+    solver.assumeProperty(diff, true);
+    double start_time = cpuTime();
+    int SAT_count = solver.assumpSolve();
+    run_time = cpuTime() - start_time;
+    return SAT_count;
+}
+
+// ATPG-like incremental queries: random values on three quarters of the product bits and on
+// one sixth of the operand bits of an n-bit multiplier
+int BenchMultiplier(SatSolver& solver, int n, int query_count, double& run_time) {
+    vector<Var> a, b;
+    for (int i=0; i<n; i++) {
+        a.push_back(solver.newVar());
+        b.push_back(solver.newVar());
+    }
+    vector<Var> p = AddMultiplier(solver, a, b);
+    double start_time = cpuTime();
+    int SAT_count = 0;
+    for (int q=0; q<query_count; q++) {
+        solver.assumeRelease();
+        for (int i=0; i<2*n; i++) {
+            if (BenchRandom() % 4 != 0) {
+                solver.assumeProperty(p[i], BenchRandom() & 1);
+            }
+        }
+        for (int i=0; i<n; i++) {
+            if (BenchRandom() % 6 == 0) {
+                solver.assumeProperty(a[i], BenchRandom() & 1);
+            }
+        }
+        SAT_count += solver.assumpSolve();
+    }
+    run_time = cpuTime() - start_time;
+    return SAT_count;
+}
+
+// satBench cpu <queries> [<density>] | miter <bits> | mult <bits> <queries>
+//     [-order=vsids|vmtf] [-chrono=<n>]
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cout << "Usage: satBench cpu <queries> [<density>] | miter <bits> | mult <bits> <queries> [-order=vsids|vmtf] [-chrono=<n>]" << endl;
+        return 1;
+    }
+    string workload = argv[1];
+    vector<int> numbers;
+    SatSolver solver;
+    solver.initialize();
+    SearchParams search_params = solver.getSearchParams();
+    for (int i=2; i<argc; i++) {
+        string value;
+        if (ParseOption(argv[i], "-order", value) && (value == "vsids" || value == "vmtf")) {
+            search_params.var_order = (value == "vmtf") ? order_VMTF : order_VSIDS;
+        }
+        else if (ParseOption(argv[i], "-chrono", value) && atoi(value.c_str()) >= 0) {
+            search_params.chrono = atoi(value.c_str());
+        }
+        else {
+            numbers.push_back(atoi(argv[i]));
+        }
+    }
+    solver.setSearchParams(search_params);
+
+    // (the run time leaves out building the model)
+    double run_time = 0;
+    int query_count = 1;
+    int SAT_count = 0;
+    if (workload == "cpu") {
+        query_count = numbers[0];
+        SAT_count = BenchCPU(solver, query_count, (numbers.size() > 1) ? numbers[1] : 4, run_time);
+    }
+    else if (workload == "miter") {
+        SAT_count = BenchMiter(solver, numbers[0], run_time);
+    }
+    else if (workload == "mult" && numbers.size() > 1) {
+        query_count = numbers[1];
+        SAT_count = BenchMultiplier(solver, numbers[0], query_count, run_time);
+    }
+    else {
+        cout << "Unknown workload " << workload << "!!!" << endl;
+        return 1;
+    }
+
+    const SolverStats& stats = solver.getStats();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%s: queries %d, SAT %d, %.2f s, conflicts %lld, decisions %lld, propagations %lld (%.2fM/s), maxrss %ld KB\n",
+        workload.c_str(), query_count, SAT_count, run_time, stats.conflicts, stats.decisions, stats.propagations,
+        stats.propagations / run_time / 1e6, usage.ru_maxrss);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include "sat.h"
+
+using namespace std;
+
+// Solver regression checks, run by "make check"
+
+// DIMACS-style literal: "v" or "-v" of the 1-based variable "v"
+Lit DimacsLit(int x) {
+    return (x > 0) ? Lit(x - 1) : ~Lit(-x - 1);
+}
+
+void AddClause(Solver& s, int a, int b = 0, int c = 0) {
+    vec<Lit> lits;
+    lits.push(DimacsLit(a));
+    if (b != 0) lits.push(DimacsLit(b));
+    if (c != 0) lits.push(DimacsLit(c));
+    s.addClause(lits);
+}
+
+// The formula becomes unsatisfiable only in "simplifyDB()" during the search
+// (strengthening after the learnt unit -1): the conflict of the call must be
+// empty, not the one of the previous call
+bool TestTopLevelConflict() {
+    Solver s;
+    s.subsume_interval = 1;
+    for (int i=0; i<8; i++) {
+        s.newVar();
+    }
+    AddClause(s, -1, -4);
+    AddClause(s, 1, -8);
+    AddClause(s, 2, -1, 5);
+    AddClause(s, -7);
+    AddClause(s, -4, 8);
+    AddClause(s, -2);
+    AddClause(s, 4, -5);
+    vec<Lit> assumps;
+    assumps.push(DimacsLit(7));
+    if (s.solve(assumps) || s.conflict.size() != 1) {
+        return false;
+    }
+    AddClause(s, 1, 8, 5);
+    assumps.clear();
+    return !s.solve(assumps) && !s.okay() && s.conflict.size() == 0;
+}
+
+// A group that a query does not assume stays off: its activation variable is
+// set false in the model (not true from the phase saved when it was assumed),
+// and it is not turned into a decision variable for the later queries
+bool TestUnassumedGroup() {
+    SatSolver s;
+    s.initialize();
+    Var a = s.newVar();
+    Var b = s.newVar();
+    Var f = s.newVar(false);
+    s.addAigCNF(f, a, false, b, false);
+    int g = s.newGroup();
+    Var act = s.nVars() - 1;
+    s.beginGroup(g);
+    s.assertProperty(f, true);
+    s.endGroup();
+    s.assumeGroup(g);
+    s.assumeProperty(a, true);
+    s.assumeProperty(b, true);
+    if (!s.assumpSolve() || s.getValue(act) != 1) {
+        return false;
+    }
+    for (int i=0; i<2; i++) {
+        int fallback_count = s.getStats().fallback_decisions;
+        s.assumeRelease();
+        s.assumeProperty(a, true);
+        s.assumeProperty(b, true);
+        if (!s.assumpSolve() || s.getValue(act) != 0 || s.getStats().fallback_decisions != fallback_count + 1) {
+            return false;
+        }
+    }
+    s.assumeRelease();
+    s.assumeGroup(g);
+    s.assumeProperty(a, false);
+    return !s.assumpSolve();
+}
+
+int main() {
+    int fail_count = 0;
+    if (!TestTopLevelConflict()) {
+        cout << "TestTopLevelConflict failed!!!" << endl;
+        fail_count++;
+    }
+    if (!TestUnassumedGroup()) {
+        cout << "TestUnassumedGroup failed!!!" << endl;
+        fail_count++;
+    }
+    cout << (fail_count == 0 ? "All solver checks passed" : "Solver checks failed") << endl;
+    return (fail_count == 0) ? 0 : 1;
+}